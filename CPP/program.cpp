@@ -1,25 +1,109 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <random>
 #include <chrono>
 #include <algorithm>
 #include <numeric>
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
 #include <map>
 #include <set>
 #include <iomanip>
 #include <memory>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <charconv>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <queue>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BW_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if !defined(_MSC_VER) || defined(__clang__)
+#include <cpuid.h>
+#endif
+#else
+#define BW_X86 0
+#endif
+
+// MSVC accepts any intrinsic anywhere; GCC and Clang need the target enabled per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BW_TARGET(features)
+#else
+#define BW_TARGET(features) __attribute__((target(features)))
+#endif
+
+// Compiler flags of this build for the result files. run.bat passes its cl
+// flags in; other builds may define it the same way.
+#ifndef BW_BUILD_FLAGS
+#define BW_BUILD_FLAGS "unknown"
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+// Heap traffic counters. Every allocation in the process goes through the
+// replaced operator new below, so measure() can report allocations per run.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new/delete pair is malloc/free by design
+#endif
+atomic<size_t> g_allocationCount{ 0 };
+atomic<size_t> g_allocatedBytes{ 0 };
+
+void* operator new(size_t size) {
+    g_allocationCount.fetch_add(1, memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
 struct Person {
     int id;
     string name;
     int age;
     string department;
+    uint8_t deptCode;   // interned department, index into departmentNames()
     double salary;
     system_clock::time_point hireDate;
     
@@ -38,234 +122,7252 @@ using Clock = system_clock;
 using Seconds = duration<double>;
 using Days = duration<int, ratio<86400>>;
 
-vector<Person> generateTestData(int count) {
-    vector<Person> people;
-    people.reserve(count);
-    
-    mt19937 rng(42);
-    uniform_int_distribution<int> ageDist(22, 64);
-    uniform_real_distribution<double> salaryDist(30000, 150000);
-    uniform_int_distribution<int> dayDist(1, 3650);
+// Whole days since the Unix epoch, rounded down
+int32_t epochDay(system_clock::time_point t) {
+    return chrono::floor<Days>(t.time_since_epoch()).count();
+}
+
+constexpr int kMinAge = 22;
+constexpr int kMaxAge = 64;
+
+// Age decades produced by the generator, (age / 10) * 10 in [20, 60]
+constexpr int kFirstAgeGroup = (kMinAge / 10) * 10;
+constexpr int kAgeGroupCount = kMaxAge / 10 - kMinAge / 10 + 1;
+
+// Departments are interned into small integer codes at generation time. A
+// department's code is its index in this dictionary, which is in name order,
+// so iterating or sorting by code gives the same order as comparing the strings.
+constexpr const char* kDepartmentNames[] = { "Engineering", "Finance", "HR", "Marketing", "Sales" };
+constexpr size_t kDepartmentCount = size(kDepartmentNames);
+
+const vector<string>& departmentNames() {
+    static const vector<string> names(begin(kDepartmentNames), end(kDepartmentNames));
+    return names;
+}
+
+uint8_t departmentCode(const string& department) {
+    const auto& names = departmentNames();
+    return static_cast<uint8_t>(lower_bound(names.begin(), names.end(), department) - names.begin());
+}
+
+// Test 1 result (spec.md)
+struct DepartmentStats {
+    string department;
+    size_t count;
+    double averageSalary;
+    double maxSalary;
+    int minAge;
+};
+
+// Final step of test 1: sort by average salary descending
+void sortDepartmentStats(vector<DepartmentStats>& stats) {
+    sort(stats.begin(), stats.end(),
+        [](const DepartmentStats& a, const DepartmentStats& b) { return a.averageSalary > b.averageSalary; });
+}
+
+// Sums may be accumulated in a different order, so averages are compared with a relative tolerance
+bool sameDepartmentStats(const vector<DepartmentStats>& a, const vector<DepartmentStats>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].department != b[i].department || a[i].count != b[i].count ||
+            a[i].maxSalary != b[i].maxSalary || a[i].minAge != b[i].minAge ||
+            fabs(a[i].averageSalary - b[i].averageSalary) > 1e-9 * fabs(b[i].averageSalary)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test 2 result, in (department, age group) order
+struct AgeGroupStats {
+    string department;
+    int ageGroup;
+    size_t count;
+    double totalSalary;
+    double averageTenure; // days
+};
+
+// Test 3 result, in upper-case name order. Names can repeat in a --data file,
+// so rows with the same name are ordered by id.
+struct PersonProjection {
+    int id;
+    string upperName;
+    size_t nameLength;
+    string formattedSalary;
+    bool isManager;
+};
+
+bool byUpperName(const PersonProjection& a, const PersonProjection& b) {
+    int order = a.upperName.compare(b.upperName);
+    return order != 0 ? order < 0 : a.id < b.id;
+}
+
+bool samePersonProjections(const vector<PersonProjection>& a, const vector<PersonProjection>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [](const PersonProjection& x, const PersonProjection& y) {
+        return x.id == y.id && x.upperName == y.upperName && x.nameLength == y.nameLength &&
+            x.formattedSalary == y.formattedSalary && x.isManager == y.isManager;
+    });
+}
+
+// US currency with thousands separators, "$65,432.10", like the currency
+// formats of the other implementations. to_chars rounds the exact value, as
+// printf does, without consulting the locale.
+string formatSalary(double salary) {
+    char buffer[320]; // the fixed notation of any double
+    const char* digits = buffer;
+    const char* end = to_chars(buffer, buffer + sizeof(buffer), fabs(salary), chars_format::fixed, 2).ptr;
+    const char* point = find(digits, end, '.');
     
-    // Use string_view for better performance in lookups
-    static const vector<string> names = { "John", "Jane", "Bob", "Alice", "Charlie", "Diana", "Eve", "Frank" };
-    static const vector<string> departments = { "Engineering", "Sales", "Marketing", "HR", "Finance" };
+    string text;
+    if (salary < 0) text += '-';
+    text += '$';
+    for (const char* c = digits; c != point; ++c) {
+        if (c != digits && (point - c) % 3 == 0) text += ',';
+        text += *c;
+    }
+    text.append(point, end);
+    return text;
+}
+
+bool isManager(string_view name, double salary) {
+    return (name.size() >= 7 && name.compare(name.size() - 7, 7, "Manager") == 0) || salary > 100000;
+}
+
+// Test 3 row from a name that passed the filter and its upper-case copy
+PersonProjection personProjection(int id, string upperName, string_view name, double salary) {
+    return PersonProjection{ id, move(upperName), name.size(), formatSalary(salary), isManager(name, salary) };
+}
+
+// Test 4 result
+struct DepartmentAnalysis {
+    string department;
+    size_t employeeCount;
+    size_t highEarners;
+    double averageAge;
+};
+
+// Final step of test 4: most high earners first; ties by department so the
+// order does not depend on the order groups were produced in
+void sortDepartmentAnalysis(vector<DepartmentAnalysis>& analysis) {
+    sort(analysis.begin(), analysis.end(), [](const DepartmentAnalysis& a, const DepartmentAnalysis& b) {
+        if (a.highEarners != b.highEarners) return a.highEarners > b.highEarners;
+        return a.department < b.department;
+    });
+}
+
+// Test 5 result
+struct YoungProfessional {
+    int id;
+    string name;
+    int age;
+    const char* salaryBracket;
+    double yearsOfService;
+    bool isYoungProfessional;
+};
+
+const char* salaryBracket(double salary) {
+    if (salary < 40000) return "Entry Level";
+    if (salary < 60000) return "Junior";
+    if (salary < 80000) return "Mid Level";
+    if (salary < 100000) return "Senior";
+    return "Executive";
+}
+
+bool sameRatio(double a, double b) { return fabs(a - b) <= 1e-9 * max(fabs(a), fabs(b)); }
+
+// How a kernel measures tenure. Exact kernels read hireDate as a time point,
+// like the reference; Days kernels read it at day resolution (see
+// PersonTable::hireDay) and may be a day apart per row.
+enum class Tenure { Exact, Days };
+
+bool sameAgeGroupStats(const vector<AgeGroupStats>& a, const vector<AgeGroupStats>& b, Tenure tenure = Tenure::Exact) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [tenure](const AgeGroupStats& x, const AgeGroupStats& y) {
+        bool sameTenure = tenure == Tenure::Days ? fabs(x.averageTenure - y.averageTenure) <= 1 + 1e-9
+                                                 : sameRatio(x.averageTenure, y.averageTenure);
+        return x.department == y.department && x.ageGroup == y.ageGroup && x.count == y.count &&
+            sameRatio(x.totalSalary, y.totalSalary) && sameTenure;
+    });
+}
+
+bool sameDepartmentAnalysis(const vector<DepartmentAnalysis>& a, const vector<DepartmentAnalysis>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [](const DepartmentAnalysis& x, const DepartmentAnalysis& y) {
+        return x.department == y.department && x.employeeCount == y.employeeCount &&
+            x.highEarners == y.highEarners && sameRatio(x.averageAge, y.averageAge);
+    });
+}
+
+// Many people share a hire date, so two correct top-1,000 lists can order a
+// date's rows differently and pick different people on the date where the
+// cut falls. Both lists must agree on the years of service at every
+// position, hold only young professionals, and give every person they share
+// the same fields. An Exact kernel must also pick the same people on every
+// date before the boundary one. Its years of service only drift by the time
+// between the runs. A Days kernel may be a day apart per row, and near the
+// cutoff it may select a shifted list, so only the rows both lists hold are
+// matched.
+bool sameYoungProfessionals(const vector<YoungProfessional>& a, const vector<YoungProfessional>& b, Tenure tenure = Tenure::Exact) {
+    if (a.size() != b.size()) return false;
+    const double slack = tenure == Tenure::Days ? 1.0 / 365.25 + 1e-9 : 1.0 / 365.25 / 24;
     
-    uniform_int_distribution<int> nameIndex(0, static_cast<int>(names.size()) - 1);
-    uniform_int_distribution<int> deptIndex(0, static_cast<int>(departments.size()) - 1);
+    unordered_map<int, const YoungProfessional*> reference;
+    for (const auto& y : b) reference.emplace(y.id, &y);
     
-    auto now = Clock::now();
+    for (size_t i = 0; i < a.size(); ++i) {
+        const auto& x = a[i];
+        if (fabs(x.yearsOfService - b[i].yearsOfService) > slack || !x.isYoungProfessional || x.age >= 30) return false;
+        
+        auto match = reference.find(x.id);
+        if (match == reference.end()) {
+            if (tenure == Tenure::Exact && fabs(x.yearsOfService - b.back().yearsOfService) > slack) return false;
+            continue;
+        }
+        const auto& y = *match->second;
+        if (x.name != y.name || x.age != y.age || strcmp(x.salaryBracket, y.salaryBracket) != 0 ||
+            x.isYoungProfessional != y.isYoungProfessional || fabs(x.yearsOfService - y.yearsOfService) > slack) {
+            return false;
+        }
+        reference.erase(match); // a repeated id then counts as a missing person
+    }
+    return true;
+}
+
+struct GeneratorOptions {
+    // 0 keeps the uniform department distribution; a positive value draws
+    // departments from a Zipf distribution with this exponent, so the first
+    // department in the generator's list dominates
+    double departmentSkew = 0.0;
+};
+
+// Draws single rows from the benchmark's distributions with any random engine.
+// Copies are independent, so every thread or block can own one.
+class PersonSampler {
+public:
+    explicit PersonSampler(const GeneratorOptions& options = {})
+        : options(options),
+          nameIndex(0, static_cast<int>(names().size()) - 1),
+          deptIndex(0, static_cast<int>(departments().size()) - 1),
+          now(Clock::now()) {
+        vector<double> zipfWeights;
+        for (size_t rank = 1; rank <= departments().size(); ++rank) {
+            zipfWeights.push_back(1.0 / pow(static_cast<double>(rank), options.departmentSkew));
+        }
+        zipfIndex = discrete_distribution<int>(zipfWeights.begin(), zipfWeights.end());
+        
+        for (const auto& dept : departments()) {
+            deptCodes.push_back(departmentCode(dept));
+        }
+    }
     
-    for (int i = 1; i <= count; ++i) {
-        people.emplace_back(Person{
-            i,
-            names[nameIndex(rng)] + to_string(i),
-            ageDist(rng),
-            departments[deptIndex(rng)],
+    template <typename Engine>
+    Person draw(Engine& rng, int id) {
+        // Draw in the same order as before so the generated data does not change
+        auto name = names()[nameIndex(rng)] + to_string(id);
+        int age = ageDist(rng);
+        int dept = options.departmentSkew > 0 ? zipfIndex(rng) : deptIndex(rng);
+        
+        return Person{
+            id,
+            move(name),
+            age,
+            departments()[dept],
+            deptCodes[dept],
             salaryDist(rng),
             now - Days(dayDist(rng)),
             -1 // ageGroup cache initialized
-        });
+        };
+    }
+    
+private:
+    static const vector<string>& names() {
+        static const vector<string> names = { "John", "Jane", "Bob", "Alice", "Charlie", "Diana", "Eve", "Frank" };
+        return names;
+    }
+    
+    static const vector<string>& departments() {
+        static const vector<string> departments = { "Engineering", "Sales", "Marketing", "HR", "Finance" };
+        return departments;
+    }
+    
+    GeneratorOptions options;
+    uniform_int_distribution<int> ageDist{ kMinAge, kMaxAge };
+    uniform_real_distribution<double> salaryDist{ 30000, 150000 };
+    uniform_int_distribution<int> dayDist{ 1, 3650 };
+    uniform_int_distribution<int> nameIndex;
+    uniform_int_distribution<int> deptIndex;
+    discrete_distribution<int> zipfIndex;
+    vector<uint8_t> deptCodes;
+    Clock::time_point now;
+};
+
+// Resumable generator: every call to generate() continues the same random
+// sequence and id range, so a dataset produced chunk by chunk is identical to
+// the one generateTestData() materializes in one go.
+class PersonGenerator {
+public:
+    explicit PersonGenerator(const GeneratorOptions& options = {}) : sampler(options) {}
+    
+    // Replaces the contents of people with the next count rows
+    void generate(vector<Person>& people, int count) {
+        people.clear();
+        people.reserve(count);
+        
+        for (int n = 0; n < count; ++n) {
+            people.push_back(sampler.draw(rng, ++lastId));
+        }
+    }
+    
+    // Draws and discards count rows, so a generator with the dataset's options
+    // continues the stream, and its ids, where generateTestData(count) ended
+    void skip(size_t count) {
+        for (size_t n = 0; n < count; ++n) sampler.draw(rng, ++lastId);
     }
     
+    // Next ids start after id
+    void continueIdsAfter(int id) { lastId = max(lastId, id); }
+    
+private:
+    PersonSampler sampler;
+    mt19937 rng{ 42 };
+    int lastId = 0;
+};
+
+vector<Person> generateTestData(int count, const GeneratorOptions& options = {}) {
+    vector<Person> people;
+    PersonGenerator(options).generate(people, count);
     return people;
 }
 
-void measure(const string& label, const vector<Person>& people, void(*op)(const vector<Person>&)) {
-    op(people); // warm-up
+// Columnar (struct-of-arrays) copy of the dataset. Each kernel only touches the
+// columns it needs, so a scan over age/salary/hireDate streams 20 bytes per row
+// instead of the whole ~120 byte Person.
+constexpr size_t kNameHeapPadding = 32;
+
+// Read-only view of one column. The memory belongs to the table's storage:
+// vectors built by toColumnar() or a mapped dataset file.
+template <typename T>
+class Column {
+public:
+    Column() = default;
+    Column(const T* data, size_t count) : ptr(data), count(count) {}
     
-    vector<long long> times;
-    times.reserve(5);
+    template <typename Container>
+    explicit Column(const Container& c) : ptr(c.data()), count(c.size()) {}
     
-    for (int i = 0; i < 5; ++i) {
-        auto start = high_resolution_clock::now();
-        op(people);
-        auto end = high_resolution_clock::now();
-        times.push_back(duration_cast<microseconds>(end - start).count()); // Use microseconds for better precision
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    
+private:
+    const T* ptr = nullptr;
+    size_t count = 0;
+};
+
+struct PersonTable {
+    Column<int> id;
+    Column<int> age;
+    Column<double> salary;
+    Column<system_clock::time_point> hireDate;
+    
+    // hireDate as epochDay(), for kernels that only need day resolution:
+    // half the bytes of hireDate and plain integer arithmetic. The kernels
+    // over it are day-resolution variants of the time-point kernels, not
+    // exact equivalents: the generator subtracts whole days from its own
+    // time of day, so once the run's clock has crossed a UTC midnight relative
+    // to generation (a run near midnight, or any --data file) every
+    // today - hireDay tenure is one day longer and the Projection cutoff
+    // drops the rows hired exactly five years before, which the time-point
+    // filter keeps.
+    Column<int32_t> hireDay;
+    
+    // Dictionary-encoded department, same codes as Person::deptCode
+    Column<uint8_t> department;
+    vector<string> departmentDict;
+    
+    // Names are unique per row, so their dictionary degenerates into one
+    // contiguous heap addressed by offsets (size() + 1 entries). The heap ends
+    // with kNameHeapPadding zero bytes so SIMD loads may run past the last name.
+    Column<uint32_t> nameOffset;
+    Column<char> nameHeap;
+    
+    // Keeps the memory behind the columns alive
+    shared_ptr<const void> storage;
+    
+    size_t size() const { return id.size(); }
+    
+    string_view name(size_t i) const {
+        return string_view(nameHeap.data() + nameOffset[i], nameOffset[i + 1] - nameOffset[i]);
+    }
+};
+
+// Columns of people[begin, end). The vectors are filled by the calling
+// thread, so on first-touch systems they live on that thread's NUMA node.
+PersonTable toColumnar(const vector<Person>& people, size_t begin, size_t end) {
+    struct Columns {
+        vector<int> id;
+        vector<int> age;
+        vector<double> salary;
+        vector<system_clock::time_point> hireDate;
+        vector<int32_t> hireDay;
+        vector<uint8_t> department;
+        vector<uint32_t> nameOffset;
+        string nameHeap;
+    };
+    
+    auto columns = make_shared<Columns>();
+    auto& c = *columns;
+    const size_t count = end - begin;
+    
+    c.id.reserve(count);
+    c.age.reserve(count);
+    c.salary.reserve(count);
+    c.hireDate.reserve(count);
+    c.hireDay.reserve(count);
+    c.department.reserve(count);
+    c.nameOffset.reserve(count + 1);
+    
+    size_t nameBytes = 0;
+    for (size_t i = begin; i < end; ++i) {
+        nameBytes += people[i].name.size();
+    }
+    
+    c.nameHeap.reserve(nameBytes + kNameHeapPadding);
+    c.nameOffset.push_back(0);
+    
+    for (size_t i = begin; i < end; ++i) {
+        const auto& p = people[i];
+        c.id.push_back(p.id);
+        c.age.push_back(p.age);
+        c.salary.push_back(p.salary);
+        c.hireDate.push_back(p.hireDate);
+        c.hireDay.push_back(epochDay(p.hireDate));
+        c.department.push_back(p.deptCode);
+        c.nameHeap += p.name;
+        c.nameOffset.push_back(static_cast<uint32_t>(c.nameHeap.size()));
     }
     
-    auto avg = accumulate(times.begin(), times.end(), 0LL) / static_cast<long long>(times.size());
-    auto minTime = *min_element(times.begin(), times.end());
-    auto maxTime = *max_element(times.begin(), times.end());
+    c.nameHeap.append(kNameHeapPadding, '\0');
     
-    cout << setw(25) << left << label << ": "
-         << "Avg: " << fixed << setprecision(2) << avg / 1000.0 << "ms, "
-         << "Min: " << minTime / 1000.0 << "ms, "
-         << "Max: " << maxTime / 1000.0 << "ms" << endl;
+    PersonTable table;
+    table.id = Column<int>(c.id);
+    table.age = Column<int>(c.age);
+    table.salary = Column<double>(c.salary);
+    table.hireDate = Column<system_clock::time_point>(c.hireDate);
+    table.hireDay = Column<int32_t>(c.hireDay);
+    table.department = Column<uint8_t>(c.department);
+    table.departmentDict = departmentNames();
+    table.nameOffset = Column<uint32_t>(c.nameOffset);
+    table.nameHeap = Column<char>(c.nameHeap);
+    table.storage = move(columns);
+    return table;
 }
 
-void runComplexOperations(const vector<Person>& people) {
-    // Pre-allocate with estimated size
-    vector<Person> filtered;
-    filtered.reserve(people.size() / 4); // Estimate 25% pass filter
+PersonTable toColumnar(const vector<Person>& people) {
+    return toColumnar(people, 0, people.size());
+}
+
+// Points the per-row columns of slice at rows [begin, end) of table, without
+// allocating; the dictionary, name heap and storage are left as they are
+void setSliceColumns(PersonTable& slice, const PersonTable& table, size_t begin, size_t end) {
+    const size_t count = end - begin;
+    slice.id = Column<int>(table.id.data() + begin, count);
+    slice.age = Column<int>(table.age.data() + begin, count);
+    slice.salary = Column<double>(table.salary.data() + begin, count);
+    slice.hireDate = Column<system_clock::time_point>(table.hireDate.data() + begin, count);
+    slice.hireDay = Column<int32_t>(table.hireDay.data() + begin, count);
+    slice.department = Column<uint8_t>(table.department.data() + begin, count);
+    slice.nameOffset = Column<uint32_t>(table.nameOffset.data() + begin, count + 1);
+}
+
+// View of rows [begin, end) of table, sharing its storage. Name offsets stay
+// relative to the whole name heap, so name() needs no adjustment.
+PersonTable sliceTable(const PersonTable& table, size_t begin, size_t end) {
+    PersonTable slice;
+    setSliceColumns(slice, table, begin, end);
+    slice.departmentDict = table.departmentDict;
+    slice.nameHeap = table.nameHeap;
+    slice.storage = table.storage;
+    return slice;
+}
+
+// Binary dataset file (spec.md, "Binary Dataset File"), little-endian:
+// a DatasetHeader, then the columns, each starting at a 64-byte aligned
+// offset recorded in the header:
+//   id int32[rows], age int32[rows], salary float64[rows],
+//   hireDate int64[rows] (nanoseconds since the Unix epoch, UTC),
+//   department uint8[rows], nameOffset uint32[rows + 1],
+//   nameHeap (nameHeapBytes, followed by kNameHeapPadding zero bytes),
+//   departmentDict (departmentCount NUL-terminated names, in code order)
+// mapDataset() maps the file and points the table's columns straight at it.
+
+constexpr char kDatasetMagic[8] = { 'B', 'W', 'D', 'A', 'T', 'A', '\0', '\0' };
+constexpr uint32_t kDatasetVersion = 1;
+constexpr uint32_t kDatasetByteOrder = 0x01020304;
+constexpr size_t kDatasetAlignment = 64;
+
+enum DatasetColumn { kIdColumn, kAgeColumn, kSalaryColumn, kHireDateColumn, kDepartmentColumn,
+                     kNameOffsetColumn, kNameHeapColumn, kDepartmentDictColumn, kDatasetColumnCount };
+
+struct DatasetHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t rows;
+    uint64_t departmentCount;
+    uint64_t nameHeapBytes;
+    uint64_t offset[kDatasetColumnCount];
+};
+
+static_assert(sizeof(DatasetHeader) == 104, "DatasetHeader must have no padding");
+
+void writeDataset(const PersonTable& table, const string& path) {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) throw runtime_error("cannot create " + path);
     
-    // Use copy_if for filtering
-    copy_if(people.begin(), people.end(), back_inserter(filtered),
-        [](const Person& p) { return p.age > 25 && p.salary > 50000; });
+    const size_t rows = table.size();
+    const size_t nameHeapBytes = table.nameHeap.size() - kNameHeapPadding;
     
-    // Sort the filtered results
-    sort(filtered.begin(), filtered.end(), 
-        [](const Person& a, const Person& b) {
-            // Avoid tuple construction for better performance
-            if (a.department != b.department) return a.department < b.department;
-            return a.salary > b.salary; // Descending salary
-        });
+    vector<int64_t> hireDate;
+    hireDate.reserve(rows);
+    for (auto t : table.hireDate) {
+        hireDate.push_back(duration_cast<nanoseconds>(t.time_since_epoch()).count());
+    }
+    
+    string departmentDict;
+    for (const auto& name : table.departmentDict) {
+        departmentDict += name;
+        departmentDict += '\0';
+    }
+    
+    const pair<const void*, size_t> columns[kDatasetColumnCount] = {
+        { table.id.data(), rows * sizeof(int32_t) },
+        { table.age.data(), rows * sizeof(int32_t) },
+        { table.salary.data(), rows * sizeof(double) },
+        { hireDate.data(), rows * sizeof(int64_t) },
+        { table.department.data(), rows },
+        { table.nameOffset.data(), (rows + 1) * sizeof(uint32_t) },
+        { table.nameHeap.data(), nameHeapBytes + kNameHeapPadding },
+        { departmentDict.data(), departmentDict.size() },
+    };
     
-    // Use unordered_map with reserve
-    unordered_map<string, vector<Person>> grouped;
-    grouped.reserve(8); // Estimate number of departments
+    DatasetHeader header{};
+    memcpy(header.magic, kDatasetMagic, sizeof(kDatasetMagic));
+    header.version = kDatasetVersion;
+    header.byteOrder = kDatasetByteOrder;
+    header.rows = rows;
+    header.departmentCount = table.departmentDict.size();
+    header.nameHeapBytes = nameHeapBytes;
     
-    for (const auto& p : filtered) {
-        grouped[p.department].push_back(p);
+    uint64_t offset = sizeof(header);
+    for (int c = 0; c < kDatasetColumnCount; ++c) {
+        offset = (offset + kDatasetAlignment - 1) / kDatasetAlignment * kDatasetAlignment;
+        header.offset[c] = offset;
+        offset += columns[c].second;
     }
     
-    for (const auto& [dept, group] : grouped) {
-        if (group.size() <= 10) continue;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int c = 0; c < kDatasetColumnCount; ++c) {
+        static const char zeros[kDatasetAlignment] = {};
+        out.write(zeros, static_cast<streamsize>(header.offset[c] - static_cast<uint64_t>(out.tellp())));
+        out.write(static_cast<const char*>(columns[c].first), static_cast<streamsize>(columns[c].second));
+    }
+    
+    if (!out) throw runtime_error("cannot write " + path);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    // The destructor does not run for a partly built object, so every failure
+    // after the open goes through release() before the exception leaves
+    explicit MappedFile(const string& path) {
+        try {
+            open(path);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+    
+    ~MappedFile() { release(); }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+    
+private:
+    void open(const string& path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw runtime_error("cannot open " + path);
         
-        // Use single pass for all aggregations
-        double totalSalary = 0;
-        double maxSalary = 0;
-        int minAge = 100;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) throw runtime_error("cannot stat " + path);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length == 0) return;
         
-        for (const auto& p : group) {
-            totalSalary += p.salary;
-            if (p.salary > maxSalary) maxSalary = p.salary;
-            if (p.age < minAge) minAge = p.age;
-        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) throw runtime_error("cannot map " + path);
+        ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("cannot open " + path);
         
-        double avgSalary = totalSalary / static_cast<double>(group.size());
-        [[maybe_unused]] auto stat = make_tuple(dept, group.size(), avgSalary, maxSalary, minAge);
+        struct stat info;
+        if (fstat(fd, &info) != 0) throw runtime_error("cannot stat " + path);
+        length = static_cast<size_t>(info.st_size);
+        if (length == 0) return;
+        
+        void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ptr = view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+#endif
+        if (!ptr) throw runtime_error("cannot map " + path);
     }
-}
+    
+    void release() {
+#if defined(_WIN32)
+        if (ptr) UnmapViewOfFile(ptr);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (ptr) munmap(const_cast<char*>(ptr), length);
+        if (fd >= 0) close(fd);
+#endif
+    }
+    
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const char* ptr = nullptr;
+    size_t length = 0;
+};
 
-void runGroupBy(const vector<Person>& people) {
-    struct Key {
-        string department;  // Use string instead of string_view
-        int ageGroup;
-        
-        bool operator<(const Key& other) const {
-            if (department != other.department) return department < other.department;
-            return ageGroup < other.ageGroup;
-        }
+// Maps a dataset file and builds a table whose columns point into the mapping.
+// hireDate is converted into an owned column only where system_clock does not
+// tick in nanoseconds (MSVC counts 100ns units). Offsets, codes and ages are
+// checked so a damaged file, or one from a writer that does not follow the
+// generator's ranges, cannot make a kernel index out of bounds.
+PersonTable mapDataset(const string& path) {
+    struct Storage {
+        explicit Storage(const string& path) : file(path) {}
+        MappedFile file;
+        vector<system_clock::time_point> hireDate;
+        vector<int32_t> hireDay;
     };
     
-    // Use map instead of unordered_map for simplicity
-    map<Key, vector<const Person*>> groups;
+    auto storage = make_shared<Storage>(path);
+    const char* base = storage->file.data();
+    const size_t fileSize = storage->file.size();
+    auto fail = [&](const string& why) { return runtime_error(path + ": " + why); };
     
-    auto now = Clock::now();
+    DatasetHeader header;
+    if (fileSize < sizeof(header)) throw fail("not a dataset file");
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, kDatasetMagic, sizeof(kDatasetMagic)) != 0) throw fail("not a dataset file");
+    if (header.byteOrder != kDatasetByteOrder) throw fail("written with a different byte order");
+    if (header.version != kDatasetVersion) throw fail("unsupported version " + to_string(header.version));
+    if (header.rows > static_cast<uint64_t>(numeric_limits<int>::max())) throw fail("too many rows");
     
-    for (const auto& p : people) {
-        Key key{ p.department, p.getAgeGroup() };
-        groups[key].push_back(&p);
+    const size_t rows = static_cast<size_t>(header.rows);
+    const uint64_t sizes[kDatasetColumnCount] = {
+        rows * sizeof(int32_t), rows * sizeof(int32_t), rows * sizeof(double), rows * sizeof(int64_t),
+        rows, (rows + 1) * sizeof(uint32_t), header.nameHeapBytes + kNameHeapPadding, 0,
+    };
+    for (int c = 0; c < kDatasetColumnCount; ++c) {
+        if (header.offset[c] % kDatasetAlignment != 0 || header.offset[c] > fileSize || sizes[c] > fileSize - header.offset[c]) {
+            throw fail("column " + to_string(c) + " lies outside the file");
+        }
     }
     
-    for (const auto& [key, group] : groups) {
-        if (group.size() <= 5) continue;
-        
-        double totalSalary = 0.0;
-        double totalTenure = 0.0;
-        
-        // Single loop for both calculations
-        for (const auto* p : group) {
-            totalSalary += p->salary;
-            totalTenure += static_cast<double>(duration_cast<Days>(now - p->hireDate).count());
+    auto columnAt = [&](int c) { return base + header.offset[c]; };
+    
+    PersonTable table;
+    table.id = Column<int>(reinterpret_cast<const int*>(columnAt(kIdColumn)), rows);
+    table.age = Column<int>(reinterpret_cast<const int*>(columnAt(kAgeColumn)), rows);
+    table.salary = Column<double>(reinterpret_cast<const double*>(columnAt(kSalaryColumn)), rows);
+    table.department = Column<uint8_t>(reinterpret_cast<const uint8_t*>(columnAt(kDepartmentColumn)), rows);
+    table.nameOffset = Column<uint32_t>(reinterpret_cast<const uint32_t*>(columnAt(kNameOffsetColumn)), rows + 1);
+    table.nameHeap = Column<char>(columnAt(kNameHeapColumn), static_cast<size_t>(header.nameHeapBytes) + kNameHeapPadding);
+    
+    const auto* hireDate = reinterpret_cast<const int64_t*>(columnAt(kHireDateColumn));
+    if constexpr (is_same_v<system_clock::duration, nanoseconds> && sizeof(system_clock::time_point) == sizeof(int64_t)) {
+        table.hireDate = Column<system_clock::time_point>(reinterpret_cast<const system_clock::time_point*>(hireDate), rows);
+    } else {
+        storage->hireDate.reserve(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            storage->hireDate.push_back(system_clock::time_point(duration_cast<system_clock::duration>(nanoseconds(hireDate[i]))));
         }
-        
-        [[maybe_unused]] double avgTenure = totalTenure / static_cast<double>(group.size());
+        table.hireDate = Column<system_clock::time_point>(storage->hireDate);
+    }
+    
+    // Derived column, not stored in the file
+    storage->hireDay.reserve(rows);
+    for (auto t : table.hireDate) storage->hireDay.push_back(epochDay(t));
+    table.hireDay = Column<int32_t>(storage->hireDay);
+    
+    const char* dict = columnAt(kDepartmentDictColumn);
+    const char* fileEnd = base + fileSize;
+    for (uint64_t d = 0; d < header.departmentCount; ++d) {
+        auto* end = static_cast<const char*>(memchr(dict, '\0', static_cast<size_t>(fileEnd - dict)));
+        if (!end) throw fail("truncated department dictionary");
+        table.departmentDict.emplace_back(dict, end);
+        dict = end + 1;
     }
+    
+    // The row kernels index departmentNames() with the same codes
+    if (table.departmentDict != departmentNames()) throw fail("department dictionary differs from this build's");
+    
+    // Ages pick the age-group slot, kFirstAgeGroup .. kMaxAge in kAgeGroupCount slots
+    for (size_t i = 0; i < rows; ++i) {
+        if (table.department[i] >= table.departmentDict.size()) throw fail("department code out of range");
+        if (table.age[i] < kMinAge || table.age[i] > kMaxAge) {
+            throw fail("age " + to_string(table.age[i]) + " outside " + to_string(kMinAge) + ".." + to_string(kMaxAge));
+        }
+    }
+    if (table.nameOffset[0] != 0 || table.nameOffset[rows] != header.nameHeapBytes) throw fail("name offsets do not cover the name heap");
+    for (size_t i = 0; i < rows; ++i) {
+        if (table.nameOffset[i] > table.nameOffset[i + 1]) throw fail("name offsets are not ascending");
+    }
+    
+    table.storage = move(storage);
+    return table;
 }
 
-void runStringOps(const vector<Person>& people) {
-    vector<string> result;
-    result.reserve(people.size() / 10); // Estimate result size
+// Replaces the contents of people with a row copy of table rows [begin, end)
+void toRows(const PersonTable& table, size_t begin, size_t end, vector<Person>& people) {
+    people.clear();
+    people.reserve(end - begin);
     
-    for (const auto& p : people) {
-        // Early exit optimization
-        if (p.name.find('a') == string::npos && p.name.find('e') == string::npos)
-            continue;
-            
-        if (p.name.size() <= 5) continue; // Check size before transformation
-        
-        string upper = p.name;
-        transform(upper.begin(), upper.end(), upper.begin(), 
-            [](unsigned char c) { return static_cast<char>(toupper(c)); }); // Safer cast
-        
-        result.push_back(move(upper));
+    for (size_t i = begin; i < end; ++i) {
+        auto code = table.department[i];
+        people.push_back(Person{
+            table.id[i],
+            string(table.name(i)),
+            table.age[i],
+            table.departmentDict[code],
+            code,
+            table.salary[i],
+            table.hireDate[i],
+            -1
+        });
     }
+}
+
+// Row copy of a columnar table, for the row kernels when the data comes from a file
+vector<Person> toRows(const PersonTable& table) {
+    vector<Person> people;
+    toRows(table, 0, table.size(), people);
+    return people;
+}
+
+// Asks the OS to start reading rows [begin, end) of a mapped table in the
+// background, so the thread that copies them later does not fault on every
+// page. Only a hint: where it is unsupported nothing happens.
+void adviseWillNeed(const PersonTable& table, size_t begin, size_t end) {
+    if (begin >= end) return;
+    auto advise = [](const void* first, const void* last) {
+#if defined(_WIN32)
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range{ const_cast<void*>(first),
+            static_cast<SIZE_T>(static_cast<const char*>(last) - static_cast<const char*>(first)) };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        (void)first;
+        (void)last;
+#endif
+#else
+        static const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        auto start = reinterpret_cast<uintptr_t>(first) & ~(pageSize - 1);
+        madvise(reinterpret_cast<void*>(start), reinterpret_cast<uintptr_t>(last) - start, MADV_WILLNEED);
+#endif
+    };
     
-    sort(result.begin(), result.end());
+    advise(table.id.data() + begin, table.id.data() + end);
+    advise(table.age.data() + begin, table.age.data() + end);
+    advise(table.salary.data() + begin, table.salary.data() + end);
+    advise(table.hireDate.data() + begin, table.hireDate.data() + end);
+    advise(table.department.data() + begin, table.department.data() + end);
+    advise(table.nameOffset.data() + begin, table.nameOffset.data() + end + 1);
+    advise(table.nameHeap.data() + table.nameOffset[begin], table.nameHeap.data() + table.nameOffset[end]);
 }
 
-void runNested(const vector<Person>& people) {
-    // Use set for departments
-    set<string> departments;
+// Pins the calling thread to one CPU, or a set of them, for its lifetime and
+// then restores the previous mask. Threads that already exist keep their own affinity.
+class AffinityScope {
+public:
+    explicit AffinityScope(int cpu) : AffinityScope(cpu < 0 ? vector<int>{} : vector<int>{ cpu }) {}
     
-    for (const auto& p : people) {
-        departments.insert(p.department);
+    // Lets the thread run on any of cpus; an empty list leaves it unpinned
+    explicit AffinityScope(const vector<int>& cpus) {
+        if (cpus.empty()) return;
+#if defined(_WIN32)
+        // Processor group 0 only
+        DWORD_PTR mask = 0;
+        for (int cpu : cpus) {
+            if (cpu < static_cast<int>(sizeof(mask) * 8)) mask |= DWORD_PTR(1) << cpu;
+        }
+        previous = SetThreadAffinityMask(GetCurrentThread(), mask);
+        pinned = previous != 0;
+#elif defined(__linux__)
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpus) {
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+        }
+        pinned = sched_getaffinity(0, sizeof(previous), &previous) == 0 && sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#endif
     }
     
-    for (const auto& dept : departments) {
-        vector<const Person*> group;
-        group.reserve(people.size() / departments.size()); // Estimate group size
-        
-        int highEarners = 0;
-        int totalAge = 0;
-        
-        // Single pass through people for this department
-        for (const auto& p : people) {
-            if (p.department == dept) {
-                group.push_back(&p);
-                if (p.salary > 75000) highEarners++;
-                totalAge += p.age;
-            }
+    ~AffinityScope() {
+        if (!pinned) return;
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), previous);
+#elif defined(__linux__)
+        sched_setaffinity(0, sizeof(previous), &previous);
+#endif
+    }
+    
+    AffinityScope(const AffinityScope&) = delete;
+    AffinityScope& operator=(const AffinityScope&) = delete;
+    
+private:
+    bool pinned = false;
+#if defined(_WIN32)
+    DWORD_PTR previous = 0;
+#elif defined(__linux__)
+    cpu_set_t previous;
+#endif
+};
+
+// Fixed set of worker threads. run() executes one job on every worker at once,
+// with the calling thread taking part as worker 0, and returns when all are done.
+// When affinity is given, worker w > 0 stays on the CPUs in affinity[w] for its
+// whole life; worker 0 is the caller, which pins itself if it needs to.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads, vector<vector<int>> affinity = {})
+        : threadCount(max(1u, threads)), affinity(move(affinity)) {
+        for (unsigned worker = 1; worker < threadCount; ++worker) {
+            workers.emplace_back([this, worker] { workerLoop(worker); });
         }
-        
-        if (group.size() > 50) {
-            [[maybe_unused]] double avgAge = static_cast<double>(totalAge) / static_cast<double>(group.size());
+    }
+    
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
         }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
     }
-}
-
-void runProjection(const vector<Person>& people) {
-    auto now = Clock::now();
-    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
     
-    vector<const Person*> result;
-    result.reserve(people.size() / 20); // Estimate result size
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
     
-    // Filter the people
-    for (const auto& p : people) {
-        if (p.hireDate > cutoff && p.age < 30 && p.salary > 60000) {
-            result.push_back(&p);
+    unsigned size() const { return threadCount; }
+    
+    void run(const function<void(unsigned)>& fn) {
+        {
+            lock_guard<mutex> lock(m);
+            job = &fn;
+            pending = threadCount - 1;
+            ++generation;
         }
+        wake.notify_all();
+        
+        fn(0);
+        
+        unique_lock<mutex> lock(m);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
     }
     
-    sort(result.begin(), result.end(), 
-        [](const Person* a, const Person* b) {
-            return a->hireDate < b->hireDate;
+    // Splits [0, count) into size() contiguous parts and calls fn(part, begin, end) for each
+    template <typename F>
+    void parallelFor(size_t count, F&& fn) {
+        run([&](unsigned part) {
+            size_t begin = count * part / threadCount;
+            size_t end = count * (part + 1) / threadCount;
+            if (begin < end) fn(part, begin, end);
         });
+    }
     
-    if (result.size() > 1000) {
-        result.resize(1000);
+private:
+    void workerLoop(unsigned worker) {
+        AffinityScope pin(worker < affinity.size() ? affinity[worker] : vector<int>{});
+        uint64_t seen = 0;
+        for (;;) {
+            const function<void(unsigned)>* current;
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                current = job;
+            }
+            
+            (*current)(worker);
+            
+            lock_guard<mutex> lock(m);
+            if (--pending == 0) done.notify_one();
+        }
     }
-}
+    
+    unsigned threadCount;
+    vector<vector<int>> affinity;
+    vector<thread> workers;
+    mutex m;
+    condition_variable wake;
+    condition_variable done;
+    const function<void(unsigned)>* job = nullptr;
+    unsigned pending = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
 
-int main() {
-    cout << "Running optimized native C++\n";
-    cout << "Architecture: " << (sizeof(void*) == 8 ? "x64" : "x86") << "\n\n";
+// Blocking FIFO of at most capacity items between threads. push() waits while
+// the queue is full, which is the backpressure on a producer that runs ahead,
+// and returns false once it is closed; pop() waits while it is empty and
+// returns false once it is closed and drained.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(max<size_t>(1, capacity)) {}
     
-    auto people = generateTestData(1'000'000);
+    bool push(T value) {
+        unique_lock<mutex> lock(m);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(move(value));
+        notEmpty.notify_one();
+        return true;
+    }
     
-    // Warm-up with smaller dataset
-    auto warmupData = vector<Person>(people.begin(), people.begin() + 1000);
-    runComplexOperations(warmupData);
+    bool pop(T& value) {
+        unique_lock<mutex> lock(m);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        value = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    
+    // No more pushes; pop() drains what is left, then returns false
+    void close() {
+        lock_guard<mutex> lock(m);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+    
+private:
+    size_t capacity;
+    deque<T> items;
+    mutex m;
+    condition_variable notFull;
+    condition_variable notEmpty;
+    bool closed = false;
+};
+
+// Sorts each of size() slices in parallel, then merges neighbouring slices pairwise
+template <typename T, typename Compare>
+void parallelSort(ThreadPool& pool, vector<T>& data, Compare cmp) {
+    const size_t parts = pool.size();
+    vector<size_t> bounds(parts + 1);
+    for (size_t i = 0; i <= parts; ++i) {
+        bounds[i] = data.size() * i / parts;
+    }
+    
+    pool.parallelFor(parts, [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], cmp);
+        }
+    });
+    
+    for (size_t width = 1; width < parts; width *= 2) {
+        size_t merges = (parts + 2 * width - 1) / (2 * width);
+        pool.parallelFor(merges, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t lo = i * 2 * width;
+                size_t mid = min(lo + width, parts);
+                size_t hi = min(lo + 2 * width, parts);
+                if (mid < hi) {
+                    inplace_merge(data.begin() + bounds[lo], data.begin() + bounds[mid], data.begin() + bounds[hi], cmp);
+                }
+            }
+        });
+    }
+}
+
+// Moves per-thread partial results into one vector, preserving part order
+template <typename T>
+vector<T> concatParts(ThreadPool& pool, vector<vector<T>>& parts) {
+    vector<size_t> offsets(parts.size() + 1, 0);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        offsets[i + 1] = offsets[i] + parts[i].size();
+    }
+    
+    vector<T> result(offsets.back());
+    pool.parallelFor(parts.size(), [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            move(parts[i].begin(), parts[i].end(), result.begin() + offsets[i]);
+        }
+    });
+    
+    return result;
+}
+
+// Counter-based random engine: the n-th output is the SplitMix64 finalizer
+// applied to seed + n * golden gamma, so any stream position is cheap to reach
+// and streams with different seeds are independent.
+struct SplitMix64 {
+    using result_type = uint64_t;
+    
+    uint64_t state;
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return numeric_limits<result_type>::max(); }
+    
+    result_type operator()() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Rows per generator block; every block has its own random stream
+constexpr int kGeneratorBlock = 64 * 1024;
+
+// Parallel generator: the id range is cut into fixed blocks, and block b draws
+// from a SplitMix64 stream seeded from (42, b). The rows depend only on their
+// block, never on which thread fills it, so the output is the same for every
+// thread count. The data differs from generateTestData()'s single mt19937 run.
+vector<Person> generateTestDataBlocked(int count, ThreadPool& pool, const GeneratorOptions& options = {}) {
+    vector<Person> people(static_cast<size_t>(count));
+    PersonSampler sampler(options);
+    
+    const size_t blocks = (static_cast<size_t>(count) + kGeneratorBlock - 1) / kGeneratorBlock;
+    pool.parallelFor(blocks, [&](unsigned, size_t begin, size_t end) {
+        auto local = sampler;
+        for (size_t block = begin; block < end; ++block) {
+            SplitMix64 rng{ SplitMix64{ (uint64_t(42) << 32) ^ block }() };
+            
+            // In size_t: first + kGeneratorBlock overflows int for the last block near INT_MAX rows
+            size_t first = block * kGeneratorBlock;
+            size_t last = min(people.size(), first + kGeneratorBlock);
+            for (size_t i = first; i < last; ++i) {
+                people[i] = local.draw(rng, static_cast<int>(i + 1));
+            }
+        }
+    });
+    
+    return people;
+}
+
+// Keeps the k smallest values pushed so far under Less, in a max-heap whose
+// front is the current k-th value. A push that does not beat it costs one
+// compare, so a filter loop can feed it directly: O(m log k) instead of
+// collecting and sorting all m matches. Per-thread instances merge().
+template <typename T, typename Less, typename Alloc = allocator<T>>
+class TopK {
+public:
+    TopK(size_t k, Less less, const Alloc& alloc = Alloc())
+        : k(k), less(less), heap(alloc) {
+        heap.reserve(k);
+    }
+    
+    void push(const T& value) {
+        if (heap.size() < k) {
+            heap.push_back(value);
+            push_heap(heap.begin(), heap.end(), less);
+        } else if (k > 0 && less(value, heap.front())) {
+            pop_heap(heap.begin(), heap.end(), less);
+            heap.back() = value;
+            push_heap(heap.begin(), heap.end(), less);
+        }
+    }
+    
+    void merge(const TopK& other) {
+        for (const auto& value : other.heap) push(value);
+    }
+    
+    size_t size() const { return heap.size(); }
+    
+    // Returns the kept values in ascending order; the heap is consumed
+    vector<T, Alloc> take() {
+        sort_heap(heap.begin(), heap.end(), less);
+        return move(heap);
+    }
+    
+private:
+    size_t k;
+    Less less;
+    vector<T, Alloc> heap;
+};
+
+// Group-by key domain fixed at compile time: one cardinality per key
+// component. index() maps a key tuple onto its row-major slot, so walking the
+// slots in order visits the keys in lexicographic order.
+template <size_t... Cardinalities>
+struct KeyDomain {
+    static constexpr size_t size = (Cardinalities * ...);
+    
+    template <typename... Keys>
+    static constexpr size_t index(Keys... keys) {
+        static_assert(sizeof...(Keys) == sizeof...(Cardinalities), "one key per domain component");
+        size_t slot = 0;
+        ((slot = slot * Cardinalities + static_cast<size_t>(keys)), ...);
+        return slot;
+    }
+};
+
+// One accumulator per key of Domain in a flat array; keys are not checked
+template <typename Domain, typename Acc>
+struct FlatGroups {
+    array<Acc, Domain::size> slots{};
+    
+    template <typename... Keys>
+    Acc& operator()(Keys... keys) { return slots[Domain::index(keys...)]; }
+};
+
+// Sort engines for the two tests whose cost is dominated by a sort: the
+// (department, salary descending) order of Complex Operations and the string
+// order of String Operations. Comparison keeps std::sort; Radix replaces it
+// with the radix sorts below. Selected per test with --sort.
+enum class SortEngine { Comparison, Radix };
+
+const char* sortEngineName(SortEngine engine) {
+    return engine == SortEngine::Radix ? "radix" : "std";
+}
+
+struct SortEngines {
+    SortEngine complex = SortEngine::Comparison;
+    SortEngine strings = SortEngine::Comparison;
+};
+
+SortEngines g_sort;
+
+// Maps a double onto an unsigned integer with the same ordering
+uint64_t orderedBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Row reference with a packed sort key: group is the most significant digit
+// and must fit in one byte, key supplies the eight digits below it
+struct RadixKey {
+    uint64_t key;
+    uint32_t row;
+    uint32_t group;
+};
+
+// Stable LSD radix sort by (group, key), one byte per pass. All nine
+// histograms come from a single read of the input; a pass whose digit is the
+// same for every item is skipped, so narrow key ranges cost fewer passes.
+void radixSortKeys(vector<RadixKey>& items) {
+    constexpr unsigned kPasses = 9;
+    auto digit = [](const RadixKey& item, unsigned pass) -> size_t {
+        return pass < 8 ? (item.key >> (pass * 8)) & 0xFF : item.group & 0xFF;
+    };
+    
+    vector<array<size_t, 256>> counts(kPasses);
+    for (const auto& item : items) {
+        for (unsigned pass = 0; pass < kPasses; ++pass) ++counts[pass][digit(item, pass)];
+    }
+    
+    vector<RadixKey> scratch(items.size());
+    for (unsigned pass = 0; pass < kPasses; ++pass) {
+        auto& count = counts[pass];
+        if (find(count.begin(), count.end(), items.size()) != count.end()) continue;
+        
+        size_t offset = 0;
+        for (auto& c : count) {
+            size_t n = c;
+            c = offset;
+            offset += n;
+        }
+        for (const auto& item : items) scratch[count[digit(item, pass)]++] = item;
+        items.swap(scratch);
+    }
+}
+
+// Orders rows by department ascending, then salary descending. The radix path
+// packs department code and inverted salary bits into a RadixKey per row.
+template <typename DeptOf, typename SalaryOf>
+void sortByDepartmentSalary(uint32_t* first, uint32_t* last, DeptOf deptOf, SalaryOf salaryOf) {
+    if (g_sort.complex == SortEngine::Comparison) {
+        sort(first, last, [&](uint32_t a, uint32_t b) {
+            if (deptOf(a) != deptOf(b)) return deptOf(a) < deptOf(b);
+            return salaryOf(a) > salaryOf(b);
+        });
+        return;
+    }
+    
+    vector<RadixKey> keys;
+    keys.reserve(static_cast<size_t>(last - first));
+    for (auto* it = first; it != last; ++it) {
+        keys.push_back(RadixKey{ ~orderedBits(salaryOf(*it)), *it, deptOf(*it) });
+    }
+    
+    radixSortKeys(keys);
+    for (size_t i = 0; i < keys.size(); ++i) first[i] = keys[i].row;
+}
+
+// Below this many keys a bucket is finished with insertion sort
+constexpr size_t kRadixInsertionCutoff = 32;
+
+// Eight bytes of a string starting at depth, big-endian and zero-padded, next
+// to the string's index. Bucket passes stream this 16-byte array instead of
+// chasing every string's characters through memory.
+struct StringKey {
+    uint64_t prefix;
+    uint32_t index;
+};
+
+uint64_t stringPrefix(const string& s, size_t depth) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t byte = depth + i < s.size() ? static_cast<unsigned char>(s[depth + i]) : 0;
+        prefix |= byte << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+// MSD radix sort (American flag sort) of keys whose strings share their first
+// depth bytes, looking at prefix byte `digit`. Once all eight prefix bytes are
+// equal, strings that end inside them come first, shortest first (any padding
+// zero they have is matched by a real zero in the longer strings); the rest
+// reload their prefix from depth + 8 and continue. strings(index) is the
+// string of a key.
+template <typename Strings>
+void msdRadixSort(const Strings& strings, StringKey* first, StringKey* last, size_t depth, unsigned digit) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (n < kRadixInsertionCutoff) {
+        auto less = [&](const StringKey& a, const StringKey& b) {
+            return strings(a.index).compare(depth, string::npos, strings(b.index), depth, string::npos) < 0;
+        };
+        for (auto* it = first + 1; it < last; ++it) {
+            for (auto* j = it; j > first && less(*j, *(j - 1)); --j) swap(*j, *(j - 1));
+        }
+        return;
+    }
+    
+    if (digit == 8) {
+        auto* unfinished = partition(first, last, [&](const StringKey& k) { return strings(k.index).size() <= depth + 8; });
+        sort(first, unfinished, [&](const StringKey& a, const StringKey& b) {
+            return strings(a.index).size() < strings(b.index).size();
+        });
+        
+        for (auto* it = unfinished; it != last; ++it) it->prefix = stringPrefix(strings(it->index), depth + 8);
+        if (last - unfinished > 1) msdRadixSort(strings, unfinished, last, depth + 8, 0);
+        return;
+    }
+    
+    const unsigned shift = 56 - 8 * digit;
+    auto byteOf = [shift](const StringKey& k) { return static_cast<size_t>((k.prefix >> shift) & 0xFF); };
+    
+    array<size_t, 256> count{};
+    for (auto* it = first; it != last; ++it) ++count[byteOf(*it)];
+    
+    array<size_t, 256> start{}, next{};
+    for (size_t b = 0, offset = 0; b < count.size(); ++b) {
+        start[b] = next[b] = offset;
+        offset += count[b];
+    }
+    
+    for (size_t b = 0; b < count.size(); ++b) {
+        while (next[b] < start[b] + count[b]) {
+            size_t target = byteOf(first[next[b]]);
+            if (target == b) ++next[b];
+            else swap(first[next[b]], first[next[target]++]);
+        }
+    }
+    
+    for (size_t b = 0; b < count.size(); ++b) {
+        if (count[b] > 1) msdRadixSort(strings, first + start[b], first + start[b] + count[b], depth, digit + 1);
+    }
+}
+
+// Sorts items by the string keyOf(item) returns: sorts the keys, then moves
+// every item once into its final position
+template <typename T, typename KeyOf>
+void msdRadixSort(vector<T>& items, KeyOf keyOf) {
+    vector<StringKey> keys(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        keys[i] = StringKey{ stringPrefix(keyOf(items[i]), 0), static_cast<uint32_t>(i) };
+    }
+    
+    auto strings = [&](uint32_t index) -> const string& { return keyOf(items[index]); };
+    msdRadixSort(strings, keys.data(), keys.data() + keys.size(), 0, 0);
+    
+    vector<T> sorted;
+    sorted.reserve(items.size());
+    for (const auto& k : keys) sorted.push_back(move(items[k.index]));
+    items.swap(sorted);
+}
+
+// Final step of test 3. The radix sort leaves rows with the same name in any
+// order, so those runs are put in id order afterwards.
+void sortProjections(vector<PersonProjection>& rows) {
+    if (g_sort.strings == SortEngine::Radix) {
+        msdRadixSort(rows, [](const PersonProjection& row) -> const string& { return row.upperName; });
+        for (auto run = rows.begin(); run != rows.end();) {
+            auto next = find_if(run + 1, rows.end(), [&](const PersonProjection& row) { return row.upperName != run->upperName; });
+            if (next - run > 1) sort(run, next, byUpperName);
+            run = next;
+        }
+    } else {
+        sort(rows.begin(), rows.end(), byUpperName);
+    }
+}
+
+// Work-stealing task scheduler on top of the ThreadPool workers. Every worker
+// owns a deque: it pushes and pops its own tasks at the back and, when empty,
+// steals the oldest task from the front of another worker's deque. Tasks may
+// spawn further tasks; runAll() returns once every task has finished.
+class WorkStealingScheduler {
+public:
+    explicit WorkStealingScheduler(ThreadPool& pool) : pool(pool), queues(pool.size()) {}
+    
+    // Inside a task the new task goes to the current worker's deque, outside
+    // of runAll() tasks are dealt round-robin
+    void spawn(function<void()> task) {
+        pending.fetch_add(1, memory_order_relaxed);
+        size_t target = currentWorker >= 0 ? static_cast<size_t>(currentWorker) : nextSeed++ % queues.size();
+        
+        lock_guard<mutex> lock(queues[target].m);
+        queues[target].tasks.push_back(move(task));
+    }
+    
+    void runAll() {
+        pool.run([this](unsigned worker) {
+            currentWorker = static_cast<int>(worker);
+            
+            while (pending.load(memory_order_acquire) > 0) {
+                function<void()> task;
+                if (popLocal(worker, task) || steal(worker, task)) {
+                    task();
+                    pending.fetch_sub(1, memory_order_release);
+                } else {
+                    this_thread::yield();
+                }
+            }
+            
+            currentWorker = -1;
+        });
+    }
+    
+    size_t steals() const { return stealCount.load(memory_order_relaxed); }
+    
+private:
+    struct Queue {
+        mutex m;
+        deque<function<void()>> tasks;
+    };
+    
+    bool popLocal(unsigned worker, function<void()>& task) {
+        auto& q = queues[worker];
+        lock_guard<mutex> lock(q.m);
+        if (q.tasks.empty()) return false;
+        task = move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+    
+    bool steal(unsigned worker, function<void()>& task) {
+        for (size_t i = 1; i < queues.size(); ++i) {
+            auto& q = queues[(worker + i) % queues.size()];
+            lock_guard<mutex> lock(q.m);
+            if (q.tasks.empty()) continue;
+            task = move(q.tasks.front());
+            q.tasks.pop_front();
+            stealCount.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+    
+    ThreadPool& pool;
+    vector<Queue> queues;
+    atomic<size_t> pending{ 0 };
+    atomic<size_t> stealCount{ 0 };
+    size_t nextSeed = 0;
+    static thread_local int currentWorker;
+};
+
+thread_local int WorkStealingScheduler::currentWorker = -1;
+
+// Parallel quicksort where each partition step spawns the upper part as a new
+// task. Skewed partitions (long runs of equal departments) simply end up as
+// more work to steal instead of one fixed slice per thread.
+template <typename It, typename Compare>
+void stealingSortTask(WorkStealingScheduler& scheduler, It first, It last, Compare cmp, ptrdiff_t grain) {
+    while (last - first > grain) {
+        auto a = *first;
+        auto b = *(first + (last - first) / 2);
+        auto c = *(last - 1);
+        auto pivot = cmp(a, b) ? (cmp(b, c) ? b : (cmp(a, c) ? c : a))
+                               : (cmp(a, c) ? a : (cmp(b, c) ? c : b));
+        
+        // Three-way split: [first, lower) < pivot, [lower, upper) == pivot, [upper, last) > pivot
+        auto lower = partition(first, last, [&](const auto& x) { return cmp(x, pivot); });
+        auto upper = partition(lower, last, [&](const auto& x) { return !cmp(pivot, x); });
+        
+        if (last - upper > 1) {
+            scheduler.spawn([&scheduler, upper, last, cmp, grain] {
+                stealingSortTask(scheduler, upper, last, cmp, grain);
+            });
+        }
+        last = lower;
+    }
+    sort(first, last, cmp);
+}
+
+template <typename T, typename Compare>
+void stealingSort(WorkStealingScheduler& scheduler, vector<T>& data, Compare cmp) {
+    constexpr ptrdiff_t kSortGrain = 16 * 1024;
+    scheduler.spawn([&scheduler, &data, cmp] {
+        stealingSortTask(scheduler, data.begin(), data.end(), cmp, kSortGrain);
+    });
+    scheduler.runAll();
+}
+
+// Bump allocator for per-iteration temporaries. Deallocation is a no-op and
+// reset() rewinds everything at once. When the previous cycle overflowed into
+// extra blocks, reset() replaces them with one block of the combined size, so
+// from the second cycle on a kernel allocates nothing from the heap.
+class Arena : public pmr::memory_resource {
+public:
+    explicit Arena(size_t initialBytes = 1 << 20) {
+        addBlock(initialBytes);
+    }
+    
+    ~Arena() override {
+        for (auto& block : blocks) ::operator delete(block.data);
+    }
+    
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    
+    void reset() {
+        // Merging here rather than at the next allocation keeps the cost in the cycle that spilled
+        if (blocks.size() > 1) {
+            size_t total = 0;
+            for (auto& block : blocks) {
+                total += block.size;
+                ::operator delete(block.data);
+            }
+            blocks.clear();
+            addBlock(total);
+        }
+        blocks.back().used = 0;
+    }
+    
+private:
+    struct Block {
+        char* data;
+        size_t size;
+        size_t used;
+    };
+    
+    void addBlock(size_t size) {
+        blocks.push_back(Block{ static_cast<char*>(::operator new(size)), size, 0 });
+    }
+    
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto* block = &blocks.back();
+        auto base = reinterpret_cast<uintptr_t>(block->data);
+        size_t offset = ((base + block->used + alignment - 1) & ~(alignment - 1)) - base;
+        
+        if (offset + bytes > block->size) {
+            addBlock(max(block->size * 2, bytes + alignment));
+            block = &blocks.back();
+            base = reinterpret_cast<uintptr_t>(block->data);
+            offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+        }
+        
+        block->used = offset + bytes;
+        return block->data + offset;
+    }
+    
+    void do_deallocate(void*, size_t, size_t) override {}
+    
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+    
+    vector<Block> blocks;
+};
+
+// Rewinds the arena when it goes out of scope. Declared before any container
+// that uses the arena, so it runs after all of them are destroyed.
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) : arena(arena) {}
+    ~ArenaScope() { arena.reset(); }
+    
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    
+private:
+    Arena& arena;
+};
+
+// Vectorized filter kernels for the two predicate-heavy tests. Each kernel
+// scans the columns and writes the qualifying row indices densely into `out`,
+// which must have room for size() + kFilterSlack entries, and returns how
+// many it wrote. The kernel is picked at runtime from the CPU features.
+
+constexpr size_t kFilterSlack = 16;
+
+static_assert(sizeof(system_clock::time_point) == sizeof(int64_t), "hireDate column is read as 64-bit ticks");
+
+enum class SimdLevel { Scalar, Sse2, Avx2, Avx512 };
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx512: return "avx512";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+// Highest level both the CPU and the OS (saved register state) support
+SimdLevel detectSimdLevel() {
+#if BW_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) return SimdLevel::Sse2;
+    
+    auto xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+#else
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool avx512 = __builtin_cpu_supports("avx512f");
+#endif
+    if (avx512) return SimdLevel::Avx512;
+    if (avx2) return SimdLevel::Avx2;
+    return SimdLevel::Sse2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// Branch-free scalar fallback: every row is written, only the cursor moves conditionally
+size_t filterComplexScalar(const PersonTable& table, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const size_t count = table.size();
+    
+    size_t selected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (age[i] > 25) & (salary[i] > 50000);
+    }
+    return selected;
+}
+
+size_t filterProjectionScalar(const PersonTable& table, int64_t cutoff, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const auto* hireDate = reinterpret_cast<const int64_t*>(table.hireDate.data());
+    const size_t count = table.size();
+    
+    size_t selected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDate[i] > cutoff) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+#if BW_X86
+
+// For every 8-bit mask, the lane indices of its set bits packed to the front
+struct CompressTable {
+    alignas(32) uint32_t lanes[256][8];
+    
+    CompressTable() {
+        for (unsigned mask = 0; mask < 256; ++mask) {
+            unsigned n = 0;
+            for (unsigned lane = 0; lane < 8; ++lane) {
+                if (mask & (1u << lane)) lanes[mask][n++] = lane;
+            }
+            while (n < 8) lanes[mask][n++] = 0;
+        }
+    }
+};
+
+const CompressTable kCompress;
+
+BW_TARGET("avx2,popcnt")
+size_t filterComplexAvx2(const PersonTable& table, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const size_t count = table.size();
+    
+    const __m256i minAge = _mm256_set1_epi32(25);
+    const __m256d minSalary = _mm256_set1_pd(50000.0);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i ages = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(age + i));
+        unsigned ageMask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(ages, minAge))));
+        
+        unsigned salaryMask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)))
+            | static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i + 4), minSalary, _CMP_GT_OQ))) << 4;
+        
+        unsigned mask = ageMask & salaryMask;
+        __m256i lanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + selected), _mm256_permutevar8x32_epi32(rows, lanes));
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm256_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (age[i] > 25) & (salary[i] > 50000);
+    }
+    return selected;
+}
+
+BW_TARGET("avx2,popcnt")
+size_t filterProjectionAvx2(const PersonTable& table, int64_t cutoff, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const auto* hireDate = reinterpret_cast<const int64_t*>(table.hireDate.data());
+    const size_t count = table.size();
+    
+    const __m256i maxAge = _mm256_set1_epi32(30);
+    const __m256d minSalary = _mm256_set1_pd(60000.0);
+    const __m256i minHireDate = _mm256_set1_epi64x(cutoff);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i ages = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(age + i));
+        unsigned ageMask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(maxAge, ages))));
+        
+        unsigned salaryMask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)))
+            | static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i + 4), minSalary, _CMP_GT_OQ))) << 4;
+        
+        __m256i hire0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hireDate + i));
+        __m256i hire1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hireDate + i + 4));
+        unsigned hireMask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(hire0, minHireDate))))
+            | static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(hire1, minHireDate)))) << 4;
+        
+        unsigned mask = ageMask & salaryMask & hireMask;
+        __m256i lanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + selected), _mm256_permutevar8x32_epi32(rows, lanes));
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm256_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDate[i] > cutoff) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+BW_TARGET("avx512f,popcnt")
+size_t filterComplexAvx512(const PersonTable& table, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const size_t count = table.size();
+    
+    const __m512i minAge = _mm512_set1_epi32(25);
+    const __m512d minSalary = _mm512_set1_pd(50000.0);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i rows = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 ageMask = _mm512_cmpgt_epi32_mask(_mm512_loadu_si512(age + i), minAge);
+        __mmask16 salaryMask = static_cast<__mmask16>(
+            _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)
+            | _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i + 8), minSalary, _CMP_GT_OQ) << 8);
+        
+        __mmask16 mask = ageMask & salaryMask;
+        _mm512_mask_compressstoreu_epi32(out + selected, mask, rows);
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm512_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (age[i] > 25) & (salary[i] > 50000);
+    }
+    return selected;
+}
+
+BW_TARGET("avx512f,popcnt")
+size_t filterProjectionAvx512(const PersonTable& table, int64_t cutoff, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const auto* hireDate = reinterpret_cast<const int64_t*>(table.hireDate.data());
+    const size_t count = table.size();
+    
+    const __m512i maxAge = _mm512_set1_epi32(30);
+    const __m512d minSalary = _mm512_set1_pd(60000.0);
+    const __m512i minHireDate = _mm512_set1_epi64(cutoff);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i rows = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 ageMask = _mm512_cmpgt_epi32_mask(maxAge, _mm512_loadu_si512(age + i));
+        __mmask16 salaryMask = static_cast<__mmask16>(
+            _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)
+            | _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i + 8), minSalary, _CMP_GT_OQ) << 8);
+        __mmask16 hireMask = static_cast<__mmask16>(
+            _mm512_cmpgt_epi64_mask(_mm512_loadu_si512(hireDate + i), minHireDate)
+            | _mm512_cmpgt_epi64_mask(_mm512_loadu_si512(hireDate + i + 8), minHireDate) << 8);
+        
+        __mmask16 mask = ageMask & salaryMask & hireMask;
+        _mm512_mask_compressstoreu_epi32(out + selected, mask, rows);
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm512_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDate[i] > cutoff) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+#endif
+
+// One packed column of a block restricted to codes in [low, high)
+struct PackedRange {
+    const uint8_t* bytes;
+    unsigned bits;
+    uint32_t low;
+    uint32_t high;
+};
+
+struct FilterKernels {
+    SimdLevel level;
+    size_t (*complex)(const PersonTable&, uint32_t*);
+    size_t (*projection)(const PersonTable&, int64_t, uint32_t*);
+    size_t (*projectionDays)(const PersonTable&, int32_t, uint32_t*);
+    
+    // Bit-packed blocks: unpack count codes, or select the rows whose codes
+    // all lie in their ranges
+    void (*unpack)(const uint8_t*, unsigned, size_t, uint32_t*);
+    size_t (*selectPacked)(const PackedRange*, size_t, size_t, uint32_t*);
+};
+
+// Projection filter over the int32 epoch-day column: one compare covers 8 or
+// 16 hire dates instead of 4 or 8
+size_t filterProjectionDaysScalar(const PersonTable& table, int32_t cutoffDay, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const int32_t* hireDay = table.hireDay.data();
+    const size_t count = table.size();
+    
+    size_t selected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDay[i] > cutoffDay) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+#if BW_X86
+
+BW_TARGET("avx2,popcnt")
+size_t filterProjectionDaysAvx2(const PersonTable& table, int32_t cutoffDay, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const int32_t* hireDay = table.hireDay.data();
+    const size_t count = table.size();
+    
+    const __m256i maxAge = _mm256_set1_epi32(30);
+    const __m256d minSalary = _mm256_set1_pd(60000.0);
+    const __m256i minHireDay = _mm256_set1_epi32(cutoffDay);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i ages = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(age + i));
+        __m256i days = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hireDay + i));
+        __m256i keep = _mm256_and_si256(_mm256_cmpgt_epi32(maxAge, ages), _mm256_cmpgt_epi32(days, minHireDay));
+        unsigned intMask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(keep)));
+        
+        unsigned salaryMask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)))
+            | static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(salary + i + 4), minSalary, _CMP_GT_OQ))) << 4;
+        
+        unsigned mask = intMask & salaryMask;
+        __m256i lanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + selected), _mm256_permutevar8x32_epi32(rows, lanes));
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm256_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDay[i] > cutoffDay) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+BW_TARGET("avx512f,popcnt")
+size_t filterProjectionDaysAvx512(const PersonTable& table, int32_t cutoffDay, uint32_t* out) {
+    const int* age = table.age.data();
+    const double* salary = table.salary.data();
+    const int32_t* hireDay = table.hireDay.data();
+    const size_t count = table.size();
+    
+    const __m512i maxAge = _mm512_set1_epi32(30);
+    const __m512d minSalary = _mm512_set1_pd(60000.0);
+    const __m512i minHireDay = _mm512_set1_epi32(cutoffDay);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i rows = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 ageMask = _mm512_cmpgt_epi32_mask(maxAge, _mm512_loadu_si512(age + i));
+        __mmask16 hireMask = _mm512_cmpgt_epi32_mask(_mm512_loadu_si512(hireDay + i), minHireDay);
+        __mmask16 salaryMask = static_cast<__mmask16>(
+            _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i), minSalary, _CMP_GT_OQ)
+            | _mm512_cmp_pd_mask(_mm512_loadu_pd(salary + i + 8), minSalary, _CMP_GT_OQ) << 8);
+        
+        __mmask16 mask = ageMask & salaryMask & hireMask;
+        _mm512_mask_compressstoreu_epi32(out + selected, mask, rows);
+        selected += static_cast<size_t>(_mm_popcnt_u32(mask));
+        rows = _mm512_add_epi32(rows, step);
+    }
+    
+    for (; i < count; ++i) {
+        out[selected] = static_cast<uint32_t>(i);
+        selected += (hireDay[i] > cutoffDay) & (age[i] < 30) & (salary[i] > 60000);
+    }
+    return selected;
+}
+
+#endif
+
+// Kernels over bit-packed columns (see PackedColumn). Code j of a block that
+// starts at a multiple of 8 rows begins at bit j * bits of the block's first
+// byte, so the vector versions give each lane the 4 bytes holding its code
+// with one gather and shift the code down; codes are at most 25 bits wide, so
+// a shifted code always fits in those 4 bytes.
+
+uint32_t packedCode(const uint8_t* bytes, unsigned bits, size_t j) {
+    size_t bit = j * bits;
+    uint64_t word;
+    memcpy(&word, bytes + bit / 8, sizeof(word));
+    return static_cast<uint32_t>(word >> (bit % 8)) & static_cast<uint32_t>((uint64_t(1) << bits) - 1);
+}
+
+void unpackScalar(const uint8_t* bytes, unsigned bits, size_t count, uint32_t* out) {
+    for (size_t j = 0; j < count; ++j) out[j] = packedCode(bytes, bits, j);
+}
+
+size_t selectPackedScalar(const PackedRange* ranges, size_t columns, size_t count, uint32_t* out) {
+    size_t selected = 0;
+    for (size_t j = 0; j < count; ++j) {
+        bool keep = true;
+        for (size_t c = 0; c < columns; ++c) {
+            auto code = packedCode(ranges[c].bytes, ranges[c].bits, j);
+            keep &= (code >= ranges[c].low) & (code < ranges[c].high);
+        }
+        out[selected] = static_cast<uint32_t>(j);
+        selected += keep;
+    }
+    return selected;
+}
+
+#if BW_X86
+
+// Codes of 8 rows starting at bytes; offset and shift come from packedLanes()
+BW_TARGET("avx2")
+inline __m256i unpack8Avx2(const uint8_t* bytes, __m256i offset, __m256i shift, __m256i mask) {
+    __m256i codes = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bytes), offset, 1);
+    return _mm256_and_si256(_mm256_srlv_epi32(codes, shift), mask);
+}
+
+struct PackedLanes {
+    __m256i offset;
+    __m256i shift;
+    __m256i mask;
+};
+
+BW_TARGET("avx2")
+inline PackedLanes packedLanes(unsigned bits) {
+    const __m256i bit = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(bits)));
+    return { _mm256_srli_epi32(bit, 3), _mm256_and_si256(bit, _mm256_set1_epi32(7)),
+        _mm256_set1_epi32(static_cast<int>((uint32_t(1) << bits) - 1)) };
+}
+
+BW_TARGET("avx2")
+void unpackAvx2(const uint8_t* bytes, unsigned bits, size_t count, uint32_t* out) {
+    const auto lanes = packedLanes(bits);
+    
+    // 8 codes span exactly bits bytes
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        auto codes = unpack8Avx2(bytes + j / 8 * bits, lanes.offset, lanes.shift, lanes.mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), codes);
+    }
+    for (; j < count; ++j) out[j] = packedCode(bytes, bits, j);
+}
+
+// Lanes of 8 codes in [low, last]: max(code, low) == code && min(code, last) == code
+BW_TARGET("avx2")
+inline __m256i inRange8Avx2(const uint8_t* bytes, const PackedLanes& lanes, __m256i low, __m256i last) {
+    auto codes = unpack8Avx2(bytes, lanes.offset, lanes.shift, lanes.mask);
+    return _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(codes, low), codes),
+        _mm256_cmpeq_epi32(_mm256_min_epu32(codes, last), codes));
+}
+
+// Per-column state of selectPackedColumnsAvx2, copied out of the ranges
+// since the stores to out could otherwise alias them
+struct PackedFilterLanes {
+    const uint8_t* bytes;
+    size_t groupBytes;
+    PackedLanes lanes;
+    __m256i low;
+    __m256i last;
+};
+
+// Keep mask of group g, with the columns unrolled so their state stays in registers
+template <size_t... C>
+BW_TARGET("avx2")
+inline unsigned keepMaskAvx2(const PackedFilterLanes* columns, size_t g, index_sequence<C...>) {
+    __m256i keep = _mm256_set1_epi32(-1);
+    ((keep = _mm256_and_si256(keep, inRange8Avx2(columns[C].bytes + g * columns[C].groupBytes, columns[C].lanes, columns[C].low, columns[C].last))), ...);
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(keep)));
+}
+
+// Masks are computed for a run of groups before any row is written, since a
+// gather waits on older stores whose address is not yet known and the
+// compress stores' addresses depend on the running popcount
+template <size_t Columns>
+BW_TARGET("avx2,popcnt")
+size_t selectPackedColumnsAvx2(const PackedRange* ranges, size_t count, uint32_t* out) {
+    PackedFilterLanes columns[Columns];
+    for (size_t c = 0; c < Columns; ++c) {
+        if (ranges[c].low >= ranges[c].high) return 0;
+        columns[c] = PackedFilterLanes{ ranges[c].bytes, ranges[c].bits, packedLanes(ranges[c].bits),
+            _mm256_set1_epi32(static_cast<int>(ranges[c].low)), _mm256_set1_epi32(static_cast<int>(ranges[c].high - 1)) };
+    }
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    
+    constexpr size_t kRunGroups = 128;
+    uint8_t masks[kRunGroups];
+    
+    size_t selected = 0;
+    size_t j = 0;
+    while (j + 8 <= count) {
+        const size_t groups = min(kRunGroups, (count - j) / 8);
+        for (size_t g = 0; g < groups; ++g) {
+            masks[g] = static_cast<uint8_t>(keepMaskAvx2(columns, j / 8 + g, make_index_sequence<Columns>{}));
+        }
+        
+        for (size_t g = 0; g < groups; ++g) {
+            __m256i compress = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress.lanes[masks[g]]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + selected), _mm256_permutevar8x32_epi32(rows, compress));
+            selected += static_cast<size_t>(_mm_popcnt_u32(masks[g]));
+            rows = _mm256_add_epi32(rows, step);
+        }
+        j += groups * 8;
+    }
+    
+    for (; j < count; ++j) {
+        bool keep = true;
+        for (size_t c = 0; c < Columns; ++c) {
+            auto code = packedCode(ranges[c].bytes, ranges[c].bits, j);
+            keep &= (code >= ranges[c].low) & (code < ranges[c].high);
+        }
+        out[selected] = static_cast<uint32_t>(j);
+        selected += keep;
+    }
+    return selected;
+}
+
+size_t selectPackedAvx2(const PackedRange* ranges, size_t columns, size_t count, uint32_t* out) {
+    switch (columns) {
+    case 1: return selectPackedColumnsAvx2<1>(ranges, count, out);
+    case 2: return selectPackedColumnsAvx2<2>(ranges, count, out);
+    case 3: return selectPackedColumnsAvx2<3>(ranges, count, out);
+    case 4: return selectPackedColumnsAvx2<4>(ranges, count, out);
+    default: return selectPackedScalar(ranges, columns, count, out);
+    }
+}
+
+#endif
+
+// There is no SSE2 filter kernel, so that level maps to the scalar one
+FilterKernels filterKernelsFor(SimdLevel level) {
+#if BW_X86
+    if (level == SimdLevel::Avx512) return { level, filterComplexAvx512, filterProjectionAvx512, filterProjectionDaysAvx512, unpackAvx2, selectPackedAvx2 };
+    if (level == SimdLevel::Avx2) return { level, filterComplexAvx2, filterProjectionAvx2, filterProjectionDaysAvx2, unpackAvx2, selectPackedAvx2 };
+#endif
+    return { SimdLevel::Scalar, filterComplexScalar, filterProjectionScalar, filterProjectionDaysScalar, unpackScalar, selectPackedScalar };
+}
+
+// Kernels used by the columnar tests; main() replaces these when --simd is given
+FilterKernels g_filters = filterKernelsFor(detectSimdLevel());
+
+// ASCII string kernels for the columnar String Operations test. Each one
+// appends the PersonProjection of every name that contains 'a' or 'e' and is
+// longer than 5 characters. None depends on the C locale, unlike toupper().
+// The vector versions test for both characters in one compare-or pass and
+// uppercase 16 or 32 bytes at a time; they rely on the name heap padding
+// for loads that run past the end of a name.
+
+char asciiUpper(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+}
+
+void collectProjectionsScalar(const PersonTable& table, vector<PersonProjection>& out) {
+    const size_t count = table.size();
+    for (size_t i = 0; i < count; ++i) {
+        auto name = table.name(i);
+        
+        bool match = false;
+        for (char c : name) match |= (c == 'a') | (c == 'e');
+        if (!match || name.size() <= 5) continue;
+        
+        string upper(name.size(), '\0');
+        for (size_t k = 0; k < name.size(); ++k) upper[k] = asciiUpper(name[k]);
+        out.push_back(personProjection(table.id[i], move(upper), name, table.salary[i]));
+    }
+}
+
+#if BW_X86
+
+// Bits [0, n) set, for n up to 32
+uint32_t laneMask(size_t n) {
+    return n >= 32 ? 0xFFFFFFFFu : (1u << n) - 1;
+}
+
+BW_TARGET("sse2")
+void collectProjectionsSse2(const PersonTable& table, vector<PersonProjection>& out) {
+    const __m128i a = _mm_set1_epi8('a');
+    const __m128i e = _mm_set1_epi8('e');
+    const __m128i beforeLower = _mm_set1_epi8('a' - 1);
+    const __m128i afterLower = _mm_set1_epi8('z' + 1);
+    const __m128i caseBit = _mm_set1_epi8('a' - 'A');
+    
+    const size_t count = table.size();
+    for (size_t i = 0; i < count; ++i) {
+        auto name = table.name(i);
+        const size_t n = name.size();
+        
+        bool match = false;
+        for (size_t off = 0; off < n && !match; off += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(name.data() + off));
+            auto hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, e))));
+            match = (hits & laneMask(n - off)) != 0;
+        }
+        if (!match || n <= 5) continue;
+        
+        string upper(n, '\0');
+        for (size_t off = 0; off < n; off += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(name.data() + off));
+            __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, beforeLower), _mm_cmplt_epi8(v, afterLower));
+            v = _mm_sub_epi8(v, _mm_and_si128(lower, caseBit));
+            
+            if (n - off >= 16) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&upper[off]), v);
+            } else {
+                alignas(16) char tail[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(tail), v);
+                memcpy(&upper[off], tail, n - off);
+            }
+        }
+        out.push_back(personProjection(table.id[i], move(upper), name, table.salary[i]));
+    }
+}
+
+BW_TARGET("avx2")
+void collectProjectionsAvx2(const PersonTable& table, vector<PersonProjection>& out) {
+    const __m256i a = _mm256_set1_epi8('a');
+    const __m256i e = _mm256_set1_epi8('e');
+    const __m256i beforeLower = _mm256_set1_epi8('a' - 1);
+    const __m256i afterLower = _mm256_set1_epi8('z' + 1);
+    const __m256i caseBit = _mm256_set1_epi8('a' - 'A');
+    
+    const size_t count = table.size();
+    for (size_t i = 0; i < count; ++i) {
+        auto name = table.name(i);
+        const size_t n = name.size();
+        
+        bool match = false;
+        for (size_t off = 0; off < n && !match; off += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(name.data() + off));
+            auto hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, e))));
+            match = (hits & laneMask(n - off)) != 0;
+        }
+        if (!match || n <= 5) continue;
+        
+        string upper(n, '\0');
+        for (size_t off = 0; off < n; off += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(name.data() + off));
+            __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(v, beforeLower), _mm256_cmpgt_epi8(afterLower, v));
+            v = _mm256_sub_epi8(v, _mm256_and_si256(lower, caseBit));
+            
+            if (n - off >= 32) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&upper[off]), v);
+            } else {
+                alignas(32) char tail[32];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(tail), v);
+                memcpy(&upper[off], tail, n - off);
+            }
+        }
+        out.push_back(personProjection(table.id[i], move(upper), name, table.salary[i]));
+    }
+}
+
+#endif
+
+struct StringKernels {
+    SimdLevel level;
+    void (*collectProjections)(const PersonTable&, vector<PersonProjection>&);
+};
+
+// Names fit in one 32-byte register, so AVX-512 has nothing to add over AVX2 here
+StringKernels stringKernelsFor(SimdLevel level) {
+#if BW_X86
+    if (level >= SimdLevel::Avx2) return { SimdLevel::Avx2, collectProjectionsAvx2 };
+    if (level == SimdLevel::Sse2) return { SimdLevel::Sse2, collectProjectionsSse2 };
+#endif
+    return { SimdLevel::Scalar, collectProjectionsScalar };
+}
+
+StringKernels g_strings = stringKernelsFor(detectSimdLevel());
+
+// Index list produced by a filter kernel; left uninitialized because the
+// kernels overwrite it anyway
+struct Selection {
+    unique_ptr<uint32_t[]> rows;
+    size_t size = 0;
+    
+    explicit Selection(size_t capacity) : rows(new uint32_t[capacity + kFilterSlack]) {}
+    
+    uint32_t* begin() { return rows.get(); }
+    uint32_t* end() { return rows.get() + size; }
+};
+
+// Alternative row layouts for the name. Person keeps a std::string per row;
+// InlinePerson stores the characters in a fixed buffer inside the row and
+// PooledPerson points into one contiguous pool shared by all rows. Both keep
+// the department as its code only.
+
+// Generated names are a prefix of up to 7 characters plus the id, so 22
+// characters cover any id that fits in an int and fill the row to 48 bytes
+constexpr size_t kInlineNameCapacity = 22;
+
+struct InlinePerson {
+    int id;
+    int age;
+    double salary;
+    system_clock::time_point hireDate;
+    uint8_t deptCode;
+    uint8_t nameLength;
+    char name[kInlineNameCapacity];
+};
+
+struct PooledPerson {
+    int id;
+    int age;
+    double salary;
+    system_clock::time_point hireDate;
+    const char* name;   // into PooledPeople::pool, not null-terminated
+    uint8_t nameLength;
+    uint8_t deptCode;
+};
+
+struct PooledPeople {
+    string pool;
+    vector<PooledPerson> rows;
+};
+
+// Uniform accessors so the row kernels can be instantiated for every layout
+string_view nameOf(const Person& p) { return p.name; }
+string_view nameOf(const InlinePerson& p) { return string_view(p.name, p.nameLength); }
+string_view nameOf(const PooledPerson& p) { return string_view(p.name, p.nameLength); }
+
+int ageGroupOf(const Person& p) { return p.getAgeGroup(); }
+
+template <typename Row>
+int ageGroupOf(const Row& p) { return (p.age / 10) * 10; }
+
+vector<InlinePerson> toInlineLayout(const vector<Person>& people) {
+    vector<InlinePerson> rows;
+    rows.reserve(people.size());
+    
+    for (const auto& p : people) {
+        if (p.name.size() > kInlineNameCapacity) throw length_error("name does not fit inline: " + p.name);
+        
+        InlinePerson row{ p.id, p.age, p.salary, p.hireDate, p.deptCode, static_cast<uint8_t>(p.name.size()), {} };
+        memcpy(row.name, p.name.data(), p.name.size());
+        rows.push_back(row);
+    }
+    
+    return rows;
+}
+
+PooledPeople toPooledLayout(const vector<Person>& people) {
+    PooledPeople pooled;
+    
+    size_t poolBytes = 0;
+    for (const auto& p : people) {
+        poolBytes += p.name.size();
+    }
+    
+    // Sized up front, so the row pointers stay valid
+    pooled.pool.reserve(poolBytes);
+    pooled.rows.reserve(people.size());
+    
+    for (const auto& p : people) {
+        if (p.name.size() > numeric_limits<uint8_t>::max()) throw length_error("name too long: " + p.name);
+        
+        auto offset = pooled.pool.size();
+        pooled.pool += p.name;
+        pooled.rows.push_back(PooledPerson{ p.id, p.age, p.salary, p.hireDate,
+            pooled.pool.data() + offset, static_cast<uint8_t>(p.name.size()), p.deptCode });
+    }
+    
+    return pooled;
+}
+
+// Bytes held by each layout, including name characters that live outside the row
+size_t footprint(const vector<Person>& people) {
+    size_t bytes = people.capacity() * sizeof(Person);
+    for (const auto& p : people) {
+        for (const auto* s : { &p.name, &p.department }) {
+            auto data = reinterpret_cast<const char*>(s->data());
+            auto self = reinterpret_cast<const char*>(s);
+            bool smallString = data >= self && data < self + sizeof(string);
+            if (!smallString) bytes += s->capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+size_t footprint(const vector<InlinePerson>& rows) {
+    return rows.capacity() * sizeof(InlinePerson);
+}
+
+size_t footprint(const PooledPeople& pooled) {
+    return pooled.rows.capacity() * sizeof(PooledPerson) + pooled.pool.capacity();
+}
+
+// Benchmark harness. Settings come from the command line; the defaults are the
+// spec's one warm-up run and five timed runs.
+struct BenchmarkConfig {
+    int warmups = 1;
+    int runs = 5;
+    
+    // When non-zero, keep repeating past runs until this much time has been
+    // measured, up to kMaxRuns
+    double budgetMs = 0;
+    
+    // CPU the measuring thread is pinned to while it times a test, -1 for none
+    int pinCpu = -1;
+};
+
+constexpr int kMaxRuns = 10'000;
+
+BenchmarkConfig g_bench;
+
+// Optimization barriers. doNotOptimize() makes the compiler treat value as
+// read and all memory as possibly written, so a result that is never looked at
+// still has to be computed; clobberMemory() forces pending stores out.
+#if defined(_MSC_VER) && !defined(__clang__)
+const volatile char* volatile g_sink;
+
+__declspec(noinline) void useCharPointer(const volatile char* p) { g_sink = p; }
+
+template <typename T>
+void doNotOptimize(const T& value) {
+    useCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+}
+
+inline void clobberMemory() { _ReadWriteBarrier(); }
+#else
+template <typename T>
+void doNotOptimize(const T& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+inline void clobberMemory() { asm volatile("" : : : "memory"); }
+#endif
+
+constexpr bool kCanPinThreads =
+#if defined(_WIN32) || defined(__linux__)
+    true;
+#else
+    false;
+#endif
+
+// Hardware event counts per timed run. An event the machine cannot count
+// (no PMU in a VM, perf_event_paranoid, no Windows API for it) stays at -1.
+struct CounterValues {
+    double instructions = -1;
+    double cycles = -1;
+    double llcMisses = -1;
+    double branchMisses = -1;
+    
+    bool any() const { return instructions >= 0 || cycles >= 0 || llcMisses >= 0 || branchMisses >= 0; }
+};
+
+// Counts the whole process, so the multi-threaded tests include their
+// ThreadPool workers. On Linux the events are opened with inherit, which
+// covers every thread created afterwards; main opens them before any pool
+// exists, and reading an event sums its live child counts. Every event is its
+// own perf_event file descriptor, so one unsupported event does not take the
+// others with it, and multiplexed counts are scaled to the full interval.
+// Windows has no user-mode API for PMU events; only cycles are read there,
+// through QueryProcessCycleTime.
+class HardwareCounters {
+public:
+    HardwareCounters() {
+#if defined(__linux__)
+        const uint64_t configs[kEvents] = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+        for (size_t i = 0; i < kEvents; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+    
+    ~HardwareCounters() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+    
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+    
+    bool available() const {
+#if defined(__linux__)
+        return any_of(begin(fds), end(fds), [](int fd) { return fd >= 0; });
+#elif defined(_WIN32)
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    void clear() {
+        totals = {};
+        runs = 0;
+    }
+    
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#elif defined(_WIN32)
+        QueryProcessCycleTime(GetCurrentProcess(), &startCycles);
+#endif
+    }
+    
+    void stop() {
+#if defined(__linux__)
+        for (size_t i = 0; i < kEvents; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value[3] = {}; // count, time enabled, time running
+            if (read(fds[i], value, sizeof(value)) == static_cast<ssize_t>(sizeof(value)) && value[2] > 0) {
+                totals[i] += static_cast<double>(value[0]) * static_cast<double>(value[1]) / static_cast<double>(value[2]);
+            }
+        }
+#elif defined(_WIN32)
+        ULONG64 endCycles = 0;
+        QueryProcessCycleTime(GetCurrentProcess(), &endCycles);
+        totals[kCycles] += static_cast<double>(endCycles - startCycles);
+#endif
+        runs++;
+    }
+    
+    // Average over the runs since clear()
+    CounterValues perRun() const {
+        CounterValues values;
+        if (runs == 0) return values;
+        auto average = [&](size_t event) { return isCounted(event) ? totals[event] / static_cast<double>(runs) : -1.0; };
+        values.instructions = average(kInstructions);
+        values.cycles = average(kCycles);
+        values.llcMisses = average(kLlcMisses);
+        values.branchMisses = average(kBranchMisses);
+        return values;
+    }
+    
+private:
+    enum Event : size_t { kInstructions, kCycles, kLlcMisses, kBranchMisses, kEvents };
+    
+    bool isCounted(size_t event) const {
+#if defined(__linux__)
+        return fds[event] >= 0;
+#elif defined(_WIN32)
+        return event == kCycles;
+#else
+        return (void)event, false;
+#endif
+    }
+    
+    array<double, kEvents> totals{};
+    size_t runs = 0;
+#if defined(__linux__)
+    int fds[kEvents] = { -1, -1, -1, -1 };
+#elif defined(_WIN32)
+    ULONG64 startCycles = 0;
+#endif
+};
+
+// Set by --counters when the machine can count at least one event
+unique_ptr<HardwareCounters> g_counters;
+
+struct Timing {
+    // Mean of the samples left after outlier rejection
+    double avg;
+    double min;
+    double max;
+    
+    // Heap allocations per timed run
+    double allocations = 0;
+    double allocatedBytes = 0;
+    
+    double median = 0;
+    double p95 = 0;
+    double stddev = 0;
+    
+    // Half-width of the 95% confidence interval of avg
+    double ci95 = 0;
+    
+    size_t runs = 0;
+    size_t outliers = 0;
+    
+    // Per timed run, when --counters is on
+    CounterValues counters;
+    
+    // Every timed run in milliseconds, in run order
+    vector<double> samples;
+};
+
+// Two-sided 95% Student t quantile; the normal one beyond 30 degrees of freedom
+double studentT95(size_t degreesOfFreedom) {
+    static const double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    return degreesOfFreedom <= size(table) ? table[degreesOfFreedom - 1] : 1.960;
+}
+
+// Linear interpolation between the closest ranks of sorted samples
+double percentile(const vector<double>& sorted, double fraction) {
+    double rank = fraction * static_cast<double>(sorted.size() - 1);
+    auto below = static_cast<size_t>(rank);
+    if (below + 1 >= sorted.size()) return sorted.back();
+    return sorted[below] + (rank - static_cast<double>(below)) * (sorted[below + 1] - sorted[below]);
+}
+
+// Statistics of the per-run times in milliseconds. Samples beyond Tukey's
+// fences (1.5 interquartile ranges past the quartiles) are dropped from the
+// mean, deviation and confidence interval; median, p95, min and max use all.
+Timing summarizeRuns(vector<double> samples, double allocations, double allocatedBytes) {
+    Timing t{};
+    t.samples = samples;
+    sort(samples.begin(), samples.end());
+    
+    t.runs = samples.size();
+    t.min = samples.front();
+    t.max = samples.back();
+    t.median = percentile(samples, 0.5);
+    t.p95 = percentile(samples, 0.95);
+    t.allocations = allocations;
+    t.allocatedBytes = allocatedBytes;
+    
+    double q1 = percentile(samples, 0.25), q3 = percentile(samples, 0.75);
+    double low = q1 - 1.5 * (q3 - q1), high = q3 + 1.5 * (q3 - q1);
+    vector<double> kept;
+    copy_if(samples.begin(), samples.end(), back_inserter(kept), [&](double s) { return s >= low && s <= high; });
+    t.outliers = samples.size() - kept.size();
+    
+    auto n = static_cast<double>(kept.size());
+    t.avg = accumulate(kept.begin(), kept.end(), 0.0) / n;
+    if (kept.size() > 1) {
+        double squares = 0;
+        for (double s : kept) squares += (s - t.avg) * (s - t.avg);
+        t.stddev = sqrt(squares / (n - 1));
+        t.ci95 = studentT95(kept.size() - 1) * t.stddev / sqrt(n);
+    }
+    return t;
+}
+
+// Times op(data) under g_bench. op may be any callable; whatever it returns is
+// passed through doNotOptimize() so the work behind it cannot be discarded.
+template <typename Data, typename Op>
+Timing measure(const Data& data, Op&& op) {
+    AffinityScope pin(g_bench.pinCpu);
+    
+    auto run = [&] {
+        if constexpr (is_void_v<invoke_result_t<Op&, const Data&>>) {
+            op(data);
+            clobberMemory();
+        } else {
+            auto result = op(data);
+            doNotOptimize(result);
+        }
+    };
+    
+    for (int i = 0; i < g_bench.warmups; ++i) run();
+    
+    const auto runs = static_cast<size_t>(g_bench.runs);
+    vector<double> times;
+    times.reserve(g_bench.budgetMs > 0 ? static_cast<size_t>(kMaxRuns) : runs);
+    double spent = 0;
+    
+    auto allocationsBefore = g_allocationCount.load();
+    auto bytesBefore = g_allocatedBytes.load();
+    
+    if (g_counters) g_counters->clear();
+    
+    while (times.size() < runs || (spent < g_bench.budgetMs && times.size() < static_cast<size_t>(kMaxRuns))) {
+        // The counter syscalls stay outside the clock
+        if (g_counters) g_counters->start();
+        auto start = high_resolution_clock::now();
+        run();
+        auto end = high_resolution_clock::now();
+        if (g_counters) g_counters->stop();
+        times.push_back(duration<double, milli>(end - start).count());
+        spent += times.back();
+    }
+    
+    // Counted outside the clock; includes the few bookkeeping allocations of this loop
+    auto count = static_cast<double>(times.size());
+    auto allocations = static_cast<double>(g_allocationCount.load() - allocationsBefore) / count;
+    auto allocatedBytes = static_cast<double>(g_allocatedBytes.load() - bytesBefore) / count;
+    
+    auto t = summarizeRuns(move(times), allocations, allocatedBytes);
+    if (g_counters) t.counters = g_counters->perRun();
+    return t;
+}
+
+// Labels carry a variant suffix ("[SoA]", ...), so the column is wider than the other languages use
+constexpr int kLabelWidth = 40;
+
+// Prints the hardware counters of one test under its timing line, in millions
+void printCounters(const CounterValues& c) {
+    auto millions = [](double value) {
+        ostringstream text;
+        if (value < 0) text << "n/a";
+        else text << fixed << setprecision(2) << value / 1e6 << "M";
+        return text.str();
+    };
+    
+    cout << setw(kLabelWidth) << left << "" << "  "
+         << "Instructions: " << millions(c.instructions) << ", "
+         << "Cycles: " << millions(c.cycles) << ", "
+         << "IPC: ";
+    if (c.instructions >= 0 && c.cycles > 0) cout << fixed << setprecision(2) << c.instructions / c.cycles;
+    else cout << "n/a";
+    cout << ", LLC misses: " << millions(c.llcMisses)
+         << ", Branch misses: " << millions(c.branchMisses) << "\n";
+}
+
+// Every printed result, kept for --json and --csv. A label "Test [variant]"
+// splits into its test name and variant; section and rows are whatever the
+// code that prints the results set them to.
+struct ResultRecord {
+    string section;
+    string name;
+    string variant;
+    size_t rows;
+    Timing timing;
+};
+
+struct ResultLog {
+    string section;
+    size_t rows = 0;
+    vector<ResultRecord> records;
+    
+    void add(const string& label, const Timing& t) {
+        auto open = label.rfind(" [");
+        if (open != string::npos && label.back() == ']') {
+            add(label.substr(0, open), label.substr(open + 2, label.size() - open - 3), rows, t);
+        } else {
+            add(label, "", rows, t);
+        }
+    }
+    
+    void add(const string& name, const string& variant, size_t rowCount, const Timing& t) {
+        records.push_back(ResultRecord{ section, name, variant, rowCount, t });
+    }
+};
+
+ResultLog g_results;
+
+// Prints one result line; when a baseline is given the speedup of the median
+// relative to it is appended, which unlike the mean ignores a stray slow run
+void printTiming(const string& label, const Timing& t, const Timing* baseline = nullptr) {
+    cout << setw(kLabelWidth) << left << label << ": "
+         << "Avg: " << fixed << setprecision(2) << t.avg << "ms +/- " << t.ci95 << ", "
+         << "Median: " << t.median << "ms, "
+         << "P95: " << t.p95 << "ms, "
+         << "Min: " << t.min << "ms, "
+         << "Max: " << t.max << "ms, "
+         << "Runs: " << t.runs;
+    if (t.outliers > 0) cout << " (" << t.outliers << (t.outliers == 1 ? " outlier)" : " outliers)");
+    cout << ", Allocs: " << llround(t.allocations) << " (" << t.allocatedBytes / (1024.0 * 1024.0) << "MB)";
+    if (baseline && t.median > 0) {
+        cout << " (" << baseline->median / t.median << "x)";
+    }
+    cout << endl;
+    
+    if (t.counters.any()) printCounters(t.counters);
+    g_results.add(label, t);
+}
+
+// Runs the row-oriented and the columnar kernel of one test and prints them next to each other
+template <typename RowResult, typename ColumnResult>
+void measureLayouts(const string& label,
+                    const vector<Person>& people, RowResult(*aos)(const vector<Person>&),
+                    const PersonTable& table, ColumnResult(*soa)(const PersonTable&)) {
+    auto rows = measure(people, aos);
+    auto columns = measure(table, soa);
+    
+    printTiming(label + " [AoS]", rows);
+    printTiming(label + " [SoA]", columns, &rows);
+}
+
+template <typename Row>
+vector<DepartmentStats> runComplexOperations(const vector<Row>& people) {
+    // Pre-allocate with estimated size
+    vector<Row> filtered;
+    filtered.reserve(people.size() / 4); // Estimate 25% pass filter
+    
+    // Use copy_if for filtering
+    copy_if(people.begin(), people.end(), back_inserter(filtered),
+        [](const Row& p) { return p.age > 25 && p.salary > 50000; });
+    
+    // Sort the filtered results
+    if (g_sort.complex == SortEngine::Radix) {
+        // Radix-sort row numbers, then gather the copies once in sorted order
+        vector<uint32_t> order(filtered.size());
+        iota(order.begin(), order.end(), 0u);
+        sortByDepartmentSalary(order.data(), order.data() + order.size(),
+            [&](uint32_t i) { return filtered[i].deptCode; },
+            [&](uint32_t i) { return filtered[i].salary; });
+        
+        vector<Row> sorted;
+        sorted.reserve(filtered.size());
+        for (auto i : order) sorted.push_back(filtered[i]);
+        filtered.swap(sorted);
+    } else {
+        sort(filtered.begin(), filtered.end(), 
+            [](const Row& a, const Row& b) {
+                // Codes are in name order, so this matches comparing the department strings
+                if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+                return a.salary > b.salary; // Descending salary
+            });
+    }
+    
+    // Dense array indexed by department code instead of a string-keyed map
+    const auto& departments = departmentNames();
+    vector<vector<Row>> grouped(departments.size());
+    
+    for (const auto& p : filtered) {
+        grouped[p.deptCode].push_back(p);
+    }
+    
+    vector<DepartmentStats> stats;
+    
+    for (size_t code = 0; code < grouped.size(); ++code) {
+        const auto& group = grouped[code];
+        if (group.size() <= 10) continue;
+        
+        // Use single pass for all aggregations
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+        
+        for (const auto& p : group) {
+            totalSalary += p.salary;
+            if (p.salary > maxSalary) maxSalary = p.salary;
+            if (p.age < minAge) minAge = p.age;
+        }
+        
+        double avgSalary = totalSalary / static_cast<double>(group.size());
+        stats.push_back(DepartmentStats{ departments[code], group.size(), avgSalary, maxSalary, minAge });
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+// Zero-copy variant of runComplexOperations: filters and sorts 32-bit row
+// indices instead of row copies. The sort already orders rows by
+// department, so every group is a contiguous run of the sorted indices and
+// needs no container of its own.
+template <typename Row>
+vector<DepartmentStats> runComplexOperationsIndexed(const vector<Row>& people) {
+    vector<uint32_t> filtered;
+    filtered.reserve(people.size() / 4);
+    
+    for (size_t i = 0; i < people.size(); ++i) {
+        if (people[i].age > 25 && people[i].salary > 50000) {
+            filtered.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    
+    sortByDepartmentSalary(filtered.data(), filtered.data() + filtered.size(),
+        [&](uint32_t i) { return people[i].deptCode; },
+        [&](uint32_t i) { return people[i].salary; });
+    
+    const auto& departments = departmentNames();
+    vector<DepartmentStats> stats;
+    
+    for (size_t begin = 0; begin < filtered.size();) {
+        auto code = people[filtered[begin]].deptCode;
+        
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+        
+        size_t end = begin;
+        for (; end < filtered.size() && people[filtered[end]].deptCode == code; ++end) {
+            const auto& p = people[filtered[end]];
+            totalSalary += p.salary;
+            if (p.salary > maxSalary) maxSalary = p.salary;
+            if (p.age < minAge) minAge = p.age;
+        }
+        
+        size_t count = end - begin;
+        if (count > 10) {
+            stats.push_back(DepartmentStats{ departments[code], count, totalSalary / static_cast<double>(count), maxSalary, minAge });
+        }
+        begin = end;
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+// One test 2 result row from slot = department code * kAgeGroupCount + age group index
+AgeGroupStats ageGroupStats(size_t slot, size_t count, double totalSalary, double totalTenure) {
+    return AgeGroupStats{ departmentNames()[slot / kAgeGroupCount], kFirstAgeGroup + 10 * static_cast<int>(slot % kAgeGroupCount),
+        count, totalSalary, totalTenure / static_cast<double>(count) };
+}
+
+template <typename Row>
+vector<AgeGroupStats> runGroupBy(const vector<Row>& people) {
+    // Dense (department code, age group) grid; walking it in index order gives
+    // the department-then-age-group order the spec sorts by
+    vector<vector<const Row*>> groups(departmentNames().size() * kAgeGroupCount);
+    
+    auto now = Clock::now();
+    
+    for (const auto& p : people) {
+        size_t slot = p.deptCode * kAgeGroupCount + (ageGroupOf(p) - kFirstAgeGroup) / 10;
+        groups[slot].push_back(&p);
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        const auto& group = groups[slot];
+        if (group.size() <= 5) continue;
+        
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+        
+        // Single loop for both calculations
+        for (const auto* p : group) {
+            totalSalary += p->salary;
+            totalTenure += static_cast<double>(duration_cast<Days>(now - p->hireDate).count());
+        }
+        
+        result.push_back(ageGroupStats(slot, group.size(), totalSalary, totalTenure));
+    }
+    return result;
+}
+
+// Per-group accumulators of the single-pass kernels. merge() folds in the
+// partial state of another chunk or thread.
+struct SalaryStats {
+    size_t count = 0;
+    double totalSalary = 0;
+    double maxSalary = 0;
+    int minAge = 100;
+    
+    void merge(const SalaryStats& other) {
+        count += other.count;
+        totalSalary += other.totalSalary;
+        maxSalary = max(maxSalary, other.maxSalary);
+        minAge = min(minAge, other.minAge);
+    }
+};
+
+struct TenureStats {
+    size_t count = 0;
+    double totalSalary = 0.0;
+    double totalTenure = 0.0;
+    
+    void merge(const TenureStats& other) {
+        count += other.count;
+        totalSalary += other.totalSalary;
+        totalTenure += other.totalTenure;
+    }
+};
+
+struct Headcount {
+    size_t employees = 0;
+    size_t highEarners = 0;
+    int64_t totalAge = 0;
+    
+    void merge(const Headcount& other) {
+        employees += other.employees;
+        highEarners += other.highEarners;
+        totalAge += other.totalAge;
+    }
+};
+
+// Single-pass GroupBy over the compile-time (department, age group) domain:
+// every row folds straight into its slot of a 25-entry accumulator array, so
+// there are no member lists, no hashing and no heap allocation at all.
+
+using DeptAgeDomain = KeyDomain<kDepartmentCount, kAgeGroupCount>;
+
+template <typename Row>
+vector<AgeGroupStats> runGroupByFlat(const vector<Row>& people) {
+    FlatGroups<DeptAgeDomain, TenureStats> groups;
+    
+    auto now = Clock::now();
+    
+    for (const auto& p : people) {
+        auto& acc = groups(p.deptCode, (ageGroupOf(p) - kFirstAgeGroup) / 10);
+        acc.count++;
+        acc.totalSalary += p.salary;
+        acc.totalTenure += static_cast<double>(duration_cast<Days>(now - p.hireDate).count());
+    }
+    
+    // Slots are in (department, age group) order already
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.slots.size(); ++slot) {
+        const auto& acc = groups.slots[slot];
+        if (acc.count <= 5) continue;
+        result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure));
+    }
+    return result;
+}
+
+template <typename Row>
+vector<PersonProjection> runStringOps(const vector<Row>& people) {
+    vector<PersonProjection> result;
+    result.reserve(people.size() / 10); // Estimate result size
+    
+    for (const auto& p : people) {
+        auto name = nameOf(p);
+        
+        // Early exit optimization
+        if (name.find('a') == string_view::npos && name.find('e') == string_view::npos)
+            continue;
+            
+        if (name.size() <= 5) continue; // Check size before transformation
+        
+        string upper(name);
+        transform(upper.begin(), upper.end(), upper.begin(), 
+            [](unsigned char c) { return static_cast<char>(toupper(c)); }); // Safer cast
+        
+        result.push_back(personProjection(p.id, move(upper), name, p.salary));
+    }
+    
+    sortProjections(result);
+    return result;
+}
+
+template <typename Row>
+vector<DepartmentAnalysis> runNested(const vector<Row>& people) {
+    // Distinct departments as a presence flag per code
+    vector<char> present(departmentNames().size(), 0);
+    size_t departmentCount = 0;
+    
+    for (const auto& p : people) {
+        if (!present[p.deptCode]) {
+            present[p.deptCode] = 1;
+            departmentCount++;
+        }
+    }
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < present.size(); ++dept) {
+        if (!present[dept]) continue;
+        
+        vector<const Row*> group;
+        group.reserve(people.size() / departmentCount); // Estimate group size
+        
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+        
+        // Single pass through people for this department
+        for (const auto& p : people) {
+            if (p.deptCode == dept) {
+                group.push_back(&p);
+                if (p.salary > 75000) highEarners++;
+                totalAge += p.age;
+            }
+        }
+        
+        if (group.size() > 50) {
+            double avgAge = static_cast<double>(totalAge) / static_cast<double>(group.size());
+            result.push_back(DepartmentAnalysis{ departmentNames()[dept], group.size(), highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+// Single-pass variant of runNested: one sweep fills a per-department accumulator
+// instead of rescanning the whole dataset once per department
+template <typename Row>
+vector<DepartmentAnalysis> runNestedSinglePass(const vector<Row>& people) {
+    struct Accumulator {
+        size_t employees = 0;
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+    };
+    
+    vector<Accumulator> groups(departmentNames().size());
+    
+    for (const auto& p : people) {
+        auto& acc = groups[p.deptCode];
+        acc.employees++;
+        if (p.salary > 75000) acc.highEarners++;
+        acc.totalAge += p.age;
+    }
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < groups.size(); ++dept) {
+        const auto& acc = groups[dept];
+        if (acc.employees > 50) {
+            double avgAge = static_cast<double>(acc.totalAge) / static_cast<double>(acc.employees);
+            result.push_back(DepartmentAnalysis{ departmentNames()[dept], acc.employees, acc.highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+// Number of rows the Projection test keeps after sorting by hire date
+constexpr size_t kProjectionLimit = 1000;
+
+// Test 5 result row; years of service at full clock resolution
+template <typename Row>
+YoungProfessional youngProfessional(const Row& p, Clock::time_point now) {
+    return YoungProfessional{ p.id, string(nameOf(p)), p.age, salaryBracket(p.salary),
+        Seconds(now - p.hireDate).count() / 86400.0 / 365.25, p.age < 30 && p.salary > 60000 };
+}
+
+template <typename Row>
+vector<YoungProfessional> runProjection(const vector<Row>& people) {
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    auto byHireDate = [](const Row* a, const Row* b) {
+        return a->hireDate < b->hireDate;
+    };
+    
+    // Filter the people straight into a bounded heap of the earliest hires
+    TopK<const Row*, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    
+    for (const auto& p : people) {
+        if (p.hireDate > cutoff && p.age < 30 && p.salary > 60000) {
+            top.push(&p);
+        }
+    }
+    
+    vector<YoungProfessional> result;
+    for (const auto* p : top.take()) result.push_back(youngProfessional(*p, now));
+    return result;
+}
+
+// Columnar versions of the five tests. They follow the same steps as the row
+// kernels above but only read the columns each step needs.
+
+// Steps 3-5 of the complex chain over rows grouped by department code
+vector<DepartmentStats> summarizeDepartments(const PersonTable& table, const vector<vector<uint32_t>>& grouped) {
+    vector<DepartmentStats> stats;
+    
+    for (size_t code = 0; code < grouped.size(); ++code) {
+        const auto& group = grouped[code];
+        if (group.size() <= 10) continue;
+        
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+        
+        for (auto row : group) {
+            totalSalary += table.salary[row];
+            if (table.salary[row] > maxSalary) maxSalary = table.salary[row];
+            if (table.age[row] < minAge) minAge = table.age[row];
+        }
+        
+        double avgSalary = totalSalary / static_cast<double>(group.size());
+        stats.push_back(DepartmentStats{ table.departmentDict[code], group.size(), avgSalary, maxSalary, minAge });
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<DepartmentStats> runComplexOperationsSoA(const PersonTable& table) {
+    Selection filtered(table.size());
+    filtered.size = g_filters.complex(table, filtered.rows.get());
+    
+    sortByDepartmentSalary(filtered.begin(), filtered.end(),
+        [&](uint32_t i) { return table.department[i]; },
+        [&](uint32_t i) { return table.salary[i]; });
+    
+    // Department codes are dense, so groups are indexed directly by code
+    vector<vector<uint32_t>> grouped(table.departmentDict.size());
+    
+    for (auto row : filtered) {
+        grouped[table.department[row]].push_back(row);
+    }
+    
+    return summarizeDepartments(table, grouped);
+}
+
+vector<AgeGroupStats> runGroupBySoA(const PersonTable& table) {
+    // Same dense (department code, age group) grid as the row version
+    vector<vector<uint32_t>> groups(table.departmentDict.size() * kAgeGroupCount);
+    
+    auto now = Clock::now();
+    const size_t count = table.size();
+    
+    for (size_t i = 0; i < count; ++i) {
+        size_t slot = table.department[i] * kAgeGroupCount + (table.age[i] / 10 - kFirstAgeGroup / 10);
+        groups[slot].push_back(static_cast<uint32_t>(i));
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        const auto& group = groups[slot];
+        if (group.size() <= 5) continue;
+        
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+        
+        for (auto row : group) {
+            totalSalary += table.salary[row];
+            totalTenure += static_cast<double>(duration_cast<Days>(now - table.hireDate[row]).count());
+        }
+        
+        result.push_back(ageGroupStats(slot, group.size(), totalSalary, totalTenure));
+    }
+    return result;
+}
+
+vector<AgeGroupStats> runGroupByFlatSoA(const PersonTable& table) {
+    FlatGroups<DeptAgeDomain, TenureStats> groups;
+    
+    auto now = Clock::now();
+    const size_t count = table.size();
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto& acc = groups(table.department[i], table.age[i] / 10 - kFirstAgeGroup / 10);
+        acc.count++;
+        acc.totalSalary += table.salary[i];
+        acc.totalTenure += static_cast<double>(duration_cast<Days>(now - table.hireDate[i]).count());
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.slots.size(); ++slot) {
+        const auto& acc = groups.slots[slot];
+        if (acc.count <= 5) continue;
+        result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure));
+    }
+    return result;
+}
+
+// Day-resolution versions of the two columnar GroupBy kernels (see
+// PersonTable::hireDay for how they can differ by a day). Tenure is
+// today - hireDay, so a group's total tenure is count * today - sum(hireDay):
+// the loop only adds integers and the subtraction happens once per group.
+struct HireDayStats {
+    size_t count = 0;
+    double totalSalary = 0.0;
+    int64_t totalHireDay = 0;
+    
+    double totalTenure(int32_t today) const {
+        return static_cast<double>(static_cast<int64_t>(count) * today - totalHireDay);
+    }
+};
+
+vector<AgeGroupStats> runGroupByDaysSoA(const PersonTable& table) {
+    vector<vector<uint32_t>> groups(table.departmentDict.size() * kAgeGroupCount);
+    
+    auto today = epochDay(Clock::now());
+    const size_t count = table.size();
+    
+    for (size_t i = 0; i < count; ++i) {
+        size_t slot = table.department[i] * kAgeGroupCount + (table.age[i] / 10 - kFirstAgeGroup / 10);
+        groups[slot].push_back(static_cast<uint32_t>(i));
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        const auto& group = groups[slot];
+        if (group.size() <= 5) continue;
+        
+        HireDayStats acc;
+        acc.count = group.size();
+        for (auto row : group) {
+            acc.totalSalary += table.salary[row];
+            acc.totalHireDay += table.hireDay[row];
+        }
+        
+        result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure(today)));
+    }
+    return result;
+}
+
+vector<AgeGroupStats> runGroupByFlatDaysSoA(const PersonTable& table) {
+    FlatGroups<DeptAgeDomain, HireDayStats> groups;
+    
+    auto today = epochDay(Clock::now());
+    const size_t count = table.size();
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto& acc = groups(table.department[i], table.age[i] / 10 - kFirstAgeGroup / 10);
+        acc.count++;
+        acc.totalSalary += table.salary[i];
+        acc.totalHireDay += table.hireDay[i];
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.slots.size(); ++slot) {
+        const auto& acc = groups.slots[slot];
+        if (acc.count <= 5) continue;
+        result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure(today)));
+    }
+    return result;
+}
+
+vector<PersonProjection> runStringOpsSoA(const PersonTable& table) {
+    vector<PersonProjection> result;
+    result.reserve(table.size() / 10);
+    
+    g_strings.collectProjections(table, result);
+    
+    sortProjections(result);
+    return result;
+}
+
+vector<DepartmentAnalysis> runNestedSoA(const PersonTable& table) {
+    vector<char> present(table.departmentDict.size(), 0);
+    for (auto code : table.department) {
+        present[code] = 1;
+    }
+    
+    const size_t count = table.size();
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < present.size(); ++dept) {
+        if (!present[dept]) continue;
+        
+        size_t employees = 0;
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+        
+        // Still one pass per department, but over a 1-byte code column
+        for (size_t i = 0; i < count; ++i) {
+            if (table.department[i] == dept) {
+                employees++;
+                if (table.salary[i] > 75000) highEarners++;
+                totalAge += table.age[i];
+            }
+        }
+        
+        if (employees > 50) {
+            double avgAge = static_cast<double>(totalAge) / static_cast<double>(employees);
+            result.push_back(DepartmentAnalysis{ table.departmentDict[dept], employees, highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+vector<DepartmentAnalysis> runNestedSinglePassSoA(const PersonTable& table) {
+    struct Accumulator {
+        size_t employees = 0;
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+    };
+    
+    vector<Accumulator> groups(table.departmentDict.size());
+    const size_t count = table.size();
+    
+    for (size_t i = 0; i < count; ++i) {
+        auto& acc = groups[table.department[i]];
+        acc.employees++;
+        if (table.salary[i] > 75000) acc.highEarners++;
+        acc.totalAge += table.age[i];
+    }
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < groups.size(); ++dept) {
+        const auto& acc = groups[dept];
+        if (acc.employees > 50) {
+            double avgAge = static_cast<double>(acc.totalAge) / static_cast<double>(acc.employees);
+            result.push_back(DepartmentAnalysis{ table.departmentDict[dept], acc.employees, acc.highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+// Test 5 result row from a table row
+YoungProfessional youngProfessional(const PersonTable& table, uint32_t row, Clock::time_point now) {
+    return YoungProfessional{ table.id[row], string(table.name(row)), table.age[row], salaryBracket(table.salary[row]),
+        Seconds(now - table.hireDate[row]).count() / 86400.0 / 365.25, table.age[row] < 30 && table.salary[row] > 60000 };
+}
+
+// The same at day resolution, for the kernels that read hireDay
+YoungProfessional youngProfessionalByDay(const PersonTable& table, uint32_t row, int32_t today) {
+    return YoungProfessional{ table.id[row], string(table.name(row)), table.age[row], salaryBracket(table.salary[row]),
+        (today - table.hireDay[row]) / 365.25, table.age[row] < 30 && table.salary[row] > 60000 };
+}
+
+vector<YoungProfessional> runProjectionSoA(const PersonTable& table) {
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    Selection filtered(table.size());
+    filtered.size = g_filters.projection(table, cutoff.time_since_epoch().count(), filtered.rows.get());
+    
+    auto byHireDate = [&](uint32_t a, uint32_t b) {
+        return table.hireDate[a] < table.hireDate[b];
+    };
+    
+    TopK<uint32_t, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    for (uint32_t row : filtered) top.push(row);
+    
+    vector<YoungProfessional> result;
+    for (auto row : top.take()) result.push_back(youngProfessional(table, row, now));
+    return result;
+}
+
+// Projection over the epoch-day column, at day resolution: it may drop the
+// rows on the cutoff day that the time-point version keeps (see
+// PersonTable::hireDay). All rows hired on one day share a day number, so
+// the day order is the hire date order up to ties within a day.
+vector<YoungProfessional> runProjectionDaysSoA(const PersonTable& table) {
+    auto now = Clock::now();
+    auto today = epochDay(now);
+    auto cutoffDay = epochDay(now - Days(static_cast<int>(365.25 * 5)));
+    
+    Selection filtered(table.size());
+    filtered.size = g_filters.projectionDays(table, cutoffDay, filtered.rows.get());
+    
+    auto byHireDay = [&](uint32_t a, uint32_t b) {
+        return table.hireDay[a] < table.hireDay[b];
+    };
+    
+    TopK<uint32_t, decltype(byHireDay)> top(kProjectionLimit, byHireDay);
+    for (uint32_t row : filtered) top.push(row);
+    
+    vector<YoungProfessional> result;
+    for (auto row : top.take()) result.push_back(youngProfessionalByDay(table, row, today));
+    return result;
+}
+
+// Times the filter and string stages alone for every SIMD level this CPU
+// supports. Each kernel's output is first checked against the scalar one.
+struct FilterInput {
+    const PersonTable* table;
+    FilterKernels kernels;
+};
+
+struct StringInput {
+    const PersonTable* table;
+    StringKernels kernels;
+};
+
+size_t runStringProjections(const StringInput& in) {
+    vector<PersonProjection> rows;
+    rows.reserve(in.table->size() / 10);
+    in.kernels.collectProjections(*in.table, rows);
+    return rows.size();
+}
+
+int64_t projectionCutoff() {
+    return (Clock::now() - Days(static_cast<int>(365.25 * 5))).time_since_epoch().count();
+}
+
+size_t runComplexFilter(const FilterInput& in) {
+    Selection selected(in.table->size());
+    return in.kernels.complex(*in.table, selected.rows.get());
+}
+
+size_t runProjectionFilter(const FilterInput& in) {
+    Selection selected(in.table->size());
+    return in.kernels.projection(*in.table, projectionCutoff(), selected.rows.get());
+}
+
+int32_t projectionCutoffDay() {
+    return epochDay(Clock::now() - Days(static_cast<int>(365.25 * 5)));
+}
+
+size_t runProjectionDaysFilter(const FilterInput& in) {
+    Selection selected(in.table->size());
+    return in.kernels.projectionDays(*in.table, projectionCutoffDay(), selected.rows.get());
+}
+
+bool sameSelection(const PersonTable& table, const FilterKernels& a, const FilterKernels& b) {
+    Selection x(table.size()), y(table.size());
+    
+    x.size = a.complex(table, x.rows.get());
+    y.size = b.complex(table, y.rows.get());
+    if (!equal(x.begin(), x.end(), y.begin(), y.end())) return false;
+    
+    auto cutoff = projectionCutoff();
+    x.size = a.projection(table, cutoff, x.rows.get());
+    y.size = b.projection(table, cutoff, y.rows.get());
+    if (!equal(x.begin(), x.end(), y.begin(), y.end())) return false;
+    
+    auto cutoffDay = projectionCutoffDay();
+    x.size = a.projectionDays(table, cutoffDay, x.rows.get());
+    y.size = b.projectionDays(table, cutoffDay, y.rows.get());
+    return equal(x.begin(), x.end(), y.begin(), y.end());
+}
+
+void measureSimdKernels(const PersonTable& table) {
+    auto scalar = filterKernelsFor(SimdLevel::Scalar);
+    auto best = detectSimdLevel();
+    
+    vector<FilterKernels> kernels{ scalar };
+    if (best >= SimdLevel::Avx2) kernels.push_back(filterKernelsFor(SimdLevel::Avx2));
+    if (best >= SimdLevel::Avx512) kernels.push_back(filterKernelsFor(SimdLevel::Avx512));
+    
+    g_results.section = "SIMD Kernels";
+    cout << "\nSIMD Kernels:\n========================\n";
+    
+    Timing complexBase{}, projectionBase{}, daysBase{};
+    for (const auto& k : kernels) {
+        if (!sameSelection(table, k, scalar)) {
+            cout << simdLevelName(k.level) << " filter output differs from scalar, skipped\n";
+            continue;
+        }
+        
+        auto complex = measure(FilterInput{ &table, k }, runComplexFilter);
+        auto projection = measure(FilterInput{ &table, k }, runProjectionFilter);
+        auto days = measure(FilterInput{ &table, k }, runProjectionDaysFilter);
+        bool isBase = k.level == SimdLevel::Scalar;
+        if (isBase) {
+            complexBase = complex;
+            projectionBase = projection;
+            daysBase = days;
+        }
+        
+        printTiming(string("Complex filter [") + simdLevelName(k.level) + "]", complex, isBase ? nullptr : &complexBase);
+        printTiming(string("Projection filter [") + simdLevelName(k.level) + "]", projection, isBase ? nullptr : &projectionBase);
+        printTiming(string("Projection filter, days [") + simdLevelName(k.level) + "]", days, isBase ? nullptr : &daysBase);
+    }
+    
+    vector<PersonProjection> expected;
+    collectProjectionsScalar(table, expected);
+    
+    Timing stringBase{};
+    for (auto level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 }) {
+        if (level > best) break;
+        auto k = stringKernelsFor(level);
+        
+        vector<PersonProjection> rows;
+        k.collectProjections(table, rows);
+        if (!samePersonProjections(rows, expected)) {
+            cout << simdLevelName(k.level) << " string kernel output differs from scalar, skipped\n";
+            continue;
+        }
+        
+        auto t = measure(StringInput{ &table, k }, runStringProjections);
+        if (level == SimdLevel::Scalar) stringBase = t;
+        printTiming(string("String projections [") + simdLevelName(k.level) + "]", t, level == SimdLevel::Scalar ? nullptr : &stringBase);
+    }
+}
+
+// Parallel versions of the five tests over the row layout. Filters run on
+// contiguous partitions, aggregations keep one accumulator set per thread and
+// merge them at the end, and sorts go through parallelSort.
+
+struct ParallelInput {
+    const vector<Person>* people;
+    ThreadPool* pool;
+};
+
+vector<DepartmentStats> runComplexOperationsParallel(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    vector<vector<Person>> parts(pool.size());
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& local = parts[part];
+        local.reserve((end - begin) / 4);
+        copy_if(people.begin() + begin, people.begin() + end, back_inserter(local),
+            [](const Person& p) { return p.age > 25 && p.salary > 50000; });
+    });
+    
+    auto filtered = concatParts(pool, parts);
+    
+    parallelSort(pool, filtered,
+        [](const Person& a, const Person& b) {
+            if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+            return a.salary > b.salary;
+        });
+    
+    // After the sort every department is one contiguous run
+    const auto& departments = departmentNames();
+    vector<size_t> runStart(departments.size() + 1, filtered.size());
+    for (size_t code = 0; code < departments.size(); ++code) {
+        runStart[code] = static_cast<size_t>(partition_point(filtered.begin(), filtered.end(),
+            [&](const Person& p) { return p.deptCode < code; }) - filtered.begin());
+    }
+    
+    vector<vector<Person>> grouped(departments.size());
+    vector<DepartmentStats> perDepartment(departments.size());
+    
+    pool.parallelFor(departments.size(), [&](unsigned, size_t begin, size_t end) {
+        for (size_t code = begin; code < end; ++code) {
+            auto& group = grouped[code];
+            group.assign(filtered.begin() + runStart[code], filtered.begin() + runStart[code + 1]);
+            if (group.size() <= 10) continue;
+            
+            double totalSalary = 0;
+            double maxSalary = 0;
+            int minAge = 100;
+            
+            for (const auto& p : group) {
+                totalSalary += p.salary;
+                if (p.salary > maxSalary) maxSalary = p.salary;
+                if (p.age < minAge) minAge = p.age;
+            }
+            
+            double avgSalary = totalSalary / static_cast<double>(group.size());
+            perDepartment[code] = DepartmentStats{ departments[code], group.size(), avgSalary, maxSalary, minAge };
+        }
+    });
+    
+    // Departments that failed the size filter were never written and have a zero count
+    vector<DepartmentStats> stats;
+    for (auto& stat : perDepartment) {
+        if (stat.count > 0) stats.push_back(move(stat));
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> runGroupByParallel(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    struct Accumulator {
+        size_t count = 0;
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+    };
+    
+    const size_t slots = departmentNames().size() * kAgeGroupCount;
+    vector<vector<Accumulator>> local(pool.size(), vector<Accumulator>(slots));
+    
+    auto now = Clock::now();
+    
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& groups = local[part];
+        for (size_t i = begin; i < end; ++i) {
+            const auto& p = people[i];
+            auto& acc = groups[p.deptCode * kAgeGroupCount + (p.getAgeGroup() - kFirstAgeGroup) / 10];
+            acc.count++;
+            acc.totalSalary += p.salary;
+            acc.totalTenure += static_cast<double>(duration_cast<Days>(now - p.hireDate).count());
+        }
+    });
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        Accumulator total;
+        for (const auto& groups : local) {
+            total.count += groups[slot].count;
+            total.totalSalary += groups[slot].totalSalary;
+            total.totalTenure += groups[slot].totalTenure;
+        }
+        
+        if (total.count <= 5) continue;
+        result.push_back(ageGroupStats(slot, total.count, total.totalSalary, total.totalTenure));
+    }
+    return result;
+}
+
+vector<PersonProjection> runStringOpsParallel(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    vector<vector<PersonProjection>> parts(pool.size());
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& local = parts[part];
+        local.reserve((end - begin) / 10);
+        
+        for (size_t i = begin; i < end; ++i) {
+            const auto& name = people[i].name;
+            if (name.find('a') == string::npos && name.find('e') == string::npos)
+                continue;
+                
+            if (name.size() <= 5) continue;
+            
+            string upper = name;
+            transform(upper.begin(), upper.end(), upper.begin(),
+                [](unsigned char c) { return static_cast<char>(toupper(c)); });
+            
+            local.push_back(personProjection(people[i].id, move(upper), name, people[i].salary));
+        }
+    });
+    
+    auto result = concatParts(pool, parts);
+    parallelSort(pool, result, byUpperName);
+    return result;
+}
+
+vector<DepartmentAnalysis> runNestedParallel(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    struct Accumulator {
+        size_t employees = 0;
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+    };
+    
+    const size_t departmentCount = departmentNames().size();
+    vector<vector<Accumulator>> local(pool.size(), vector<Accumulator>(departmentCount));
+    
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& groups = local[part];
+        for (size_t i = begin; i < end; ++i) {
+            const auto& p = people[i];
+            auto& acc = groups[p.deptCode];
+            acc.employees++;
+            if (p.salary > 75000) acc.highEarners++;
+            acc.totalAge += p.age;
+        }
+    });
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < departmentCount; ++dept) {
+        Accumulator total;
+        for (const auto& groups : local) {
+            total.employees += groups[dept].employees;
+            total.highEarners += groups[dept].highEarners;
+            total.totalAge += groups[dept].totalAge;
+        }
+        
+        if (total.employees > 50) {
+            double avgAge = static_cast<double>(total.totalAge) / static_cast<double>(total.employees);
+            result.push_back(DepartmentAnalysis{ departmentNames()[dept], total.employees, total.highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+vector<YoungProfessional> runProjectionParallel(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    auto byHireDate = [](const Person* a, const Person* b) {
+        return a->hireDate < b->hireDate;
+    };
+    
+    // One heap per worker, merged afterwards: at most size() * 1000 candidates
+    vector<TopK<const Person*, decltype(byHireDate)>> parts(pool.size(), { kProjectionLimit, byHireDate });
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& local = parts[part];
+        
+        for (size_t i = begin; i < end; ++i) {
+            const auto& p = people[i];
+            if (p.hireDate > cutoff && p.age < 30 && p.salary > 60000) {
+                local.push(&p);
+            }
+        }
+    });
+    
+    for (size_t i = 1; i < parts.size(); ++i) parts[0].merge(parts[i]);
+    
+    vector<YoungProfessional> result;
+    for (const auto* p : parts[0].take()) result.push_back(youngProfessional(*p, now));
+    return result;
+}
+
+// Work-stealing versions of the kernels whose group-level or sort work is
+// uneven. Groups are cut into fixed-size chunk tasks, so one dominant
+// department is spread over all workers instead of landing on one thread.
+
+constexpr size_t kGroupGrain = 16 * 1024;
+
+vector<DepartmentStats> runComplexOperationsStealing(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    vector<vector<Person>> parts(pool.size());
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& local = parts[part];
+        local.reserve((end - begin) / 4);
+        copy_if(people.begin() + begin, people.begin() + end, back_inserter(local),
+            [](const Person& p) { return p.age > 25 && p.salary > 50000; });
+    });
+    
+    auto filtered = concatParts(pool, parts);
+    
+    WorkStealingScheduler scheduler(pool);
+    stealingSort(scheduler, filtered,
+        [](const Person& a, const Person& b) {
+            if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+            return a.salary > b.salary;
+        });
+    
+    const auto& departments = departmentNames();
+    vector<size_t> runStart(departments.size() + 1, filtered.size());
+    for (size_t code = 0; code < departments.size(); ++code) {
+        runStart[code] = static_cast<size_t>(partition_point(filtered.begin(), filtered.end(),
+            [&](const Person& p) { return p.deptCode < code; }) - filtered.begin());
+    }
+    
+    struct Partial {
+        size_t code;
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+    };
+    
+    vector<vector<Person>> grouped(departments.size());
+    vector<Partial> partials;
+    for (size_t code = 0; code < departments.size(); ++code) {
+        grouped[code].resize(runStart[code + 1] - runStart[code]);
+        for (size_t lo = runStart[code]; lo < runStart[code + 1]; lo += kGroupGrain) {
+            partials.push_back(Partial{ code });
+        }
+    }
+    
+    size_t chunk = 0;
+    for (size_t code = 0; code < departments.size(); ++code) {
+        for (size_t lo = runStart[code]; lo < runStart[code + 1]; lo += kGroupGrain, ++chunk) {
+            size_t hi = min(lo + kGroupGrain, runStart[code + 1]);
+            scheduler.spawn([&, code, lo, hi, chunk] {
+                auto& partial = partials[chunk];
+                auto out = grouped[code].begin() + (lo - runStart[code]);
+                for (size_t i = lo; i < hi; ++i, ++out) {
+                    const auto& p = filtered[i];
+                    *out = p;
+                    partial.totalSalary += p.salary;
+                    if (p.salary > partial.maxSalary) partial.maxSalary = p.salary;
+                    if (p.age < partial.minAge) partial.minAge = p.age;
+                }
+            });
+        }
+    }
+    scheduler.runAll();
+    
+    vector<DepartmentStats> stats;
+    
+    chunk = 0;
+    for (size_t code = 0; code < departments.size(); ++code) {
+        const auto& group = grouped[code];
+        
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+        for (; chunk < partials.size() && partials[chunk].code == code; ++chunk) {
+            totalSalary += partials[chunk].totalSalary;
+            maxSalary = max(maxSalary, partials[chunk].maxSalary);
+            minAge = min(minAge, partials[chunk].minAge);
+        }
+        
+        if (group.size() <= 10) continue;
+        
+        double avgSalary = totalSalary / static_cast<double>(group.size());
+        stats.push_back(DepartmentStats{ departments[code], group.size(), avgSalary, maxSalary, minAge });
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> runGroupByStealing(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    // Same two phases as runGroupBy: collect the members of every group (per
+    // thread, so no locking), then aggregate each group
+    const size_t slots = departmentNames().size() * kAgeGroupCount;
+    vector<vector<vector<const Person*>>> local(pool.size(), vector<vector<const Person*>>(slots));
+    
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& groups = local[part];
+        for (size_t i = begin; i < end; ++i) {
+            const auto& p = people[i];
+            groups[p.deptCode * kAgeGroupCount + (p.getAgeGroup() - kFirstAgeGroup) / 10].push_back(&p);
+        }
+    });
+    
+    struct Partial {
+        size_t slot;
+        size_t count = 0;
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+    };
+    
+    vector<Partial> partials;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        for (const auto& groups : local) {
+            for (size_t lo = 0; lo < groups[slot].size(); lo += kGroupGrain) {
+                partials.push_back(Partial{ slot });
+            }
+        }
+    }
+    
+    auto now = Clock::now();
+    WorkStealingScheduler scheduler(pool);
+    
+    size_t chunk = 0;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        for (const auto& groups : local) {
+            const auto& members = groups[slot];
+            for (size_t lo = 0; lo < members.size(); lo += kGroupGrain, ++chunk) {
+                size_t hi = min(lo + kGroupGrain, members.size());
+                scheduler.spawn([&, lo, hi, chunk] {
+                    auto& partial = partials[chunk];
+                    partial.count = hi - lo;
+                    for (size_t i = lo; i < hi; ++i) {
+                        partial.totalSalary += members[i]->salary;
+                        partial.totalTenure += static_cast<double>(duration_cast<Days>(now - members[i]->hireDate).count());
+                    }
+                });
+            }
+        }
+    }
+    scheduler.runAll();
+    
+    vector<AgeGroupStats> result;
+    chunk = 0;
+    for (size_t slot = 0; slot < slots; ++slot) {
+        size_t count = 0;
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+        for (; chunk < partials.size() && partials[chunk].slot == slot; ++chunk) {
+            count += partials[chunk].count;
+            totalSalary += partials[chunk].totalSalary;
+            totalTenure += partials[chunk].totalTenure;
+        }
+        
+        if (count <= 5) continue;
+        result.push_back(ageGroupStats(slot, count, totalSalary, totalTenure));
+    }
+    return result;
+}
+
+vector<PersonProjection> runStringOpsStealing(const ParallelInput& in) {
+    const auto& people = *in.people;
+    auto& pool = *in.pool;
+    
+    vector<vector<PersonProjection>> parts(pool.size());
+    pool.parallelFor(people.size(), [&](unsigned part, size_t begin, size_t end) {
+        auto& local = parts[part];
+        local.reserve((end - begin) / 10);
+        
+        for (size_t i = begin; i < end; ++i) {
+            const auto& name = people[i].name;
+            if (name.find('a') == string::npos && name.find('e') == string::npos)
+                continue;
+                
+            if (name.size() <= 5) continue;
+            
+            string upper = name;
+            transform(upper.begin(), upper.end(), upper.begin(),
+                [](unsigned char c) { return static_cast<char>(toupper(c)); });
+            
+            local.push_back(personProjection(people[i].id, move(upper), name, people[i].salary));
+        }
+    });
+    
+    auto result = concatParts(pool, parts);
+    
+    WorkStealingScheduler scheduler(pool);
+    stealingSort(scheduler, result, byUpperName);
+    return result;
+}
+
+// Arena versions of the row kernels: same steps, but every temporary container
+// draws from the arena passed in, which is rewound when the call returns.
+
+struct ArenaInput {
+    const vector<Person>* people;
+    Arena* arena;
+};
+
+vector<DepartmentStats> runComplexOperationsArena(const ArenaInput& in) {
+    const auto& people = *in.people;
+    ArenaScope scope(*in.arena);
+    
+    pmr::vector<Person> filtered(in.arena);
+    filtered.reserve(people.size() / 4);
+    
+    copy_if(people.begin(), people.end(), back_inserter(filtered),
+        [](const Person& p) { return p.age > 25 && p.salary > 50000; });
+    
+    sort(filtered.begin(), filtered.end(),
+        [](const Person& a, const Person& b) {
+            if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+            return a.salary > b.salary;
+        });
+    
+    // The inner vectors pick up the arena through uses-allocator construction
+    const auto& departments = departmentNames();
+    pmr::vector<pmr::vector<Person>> grouped(departments.size(), in.arena);
+    
+    for (const auto& p : filtered) {
+        grouped[p.deptCode].push_back(p);
+    }
+    
+    vector<DepartmentStats> stats;
+    
+    for (size_t code = 0; code < grouped.size(); ++code) {
+        const auto& group = grouped[code];
+        if (group.size() <= 10) continue;
+        
+        double totalSalary = 0;
+        double maxSalary = 0;
+        int minAge = 100;
+        
+        for (const auto& p : group) {
+            totalSalary += p.salary;
+            if (p.salary > maxSalary) maxSalary = p.salary;
+            if (p.age < minAge) minAge = p.age;
+        }
+        
+        double avgSalary = totalSalary / static_cast<double>(group.size());
+        stats.push_back(DepartmentStats{ departments[code], group.size(), avgSalary, maxSalary, minAge });
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> runGroupByArena(const ArenaInput& in) {
+    const auto& people = *in.people;
+    ArenaScope scope(*in.arena);
+    
+    pmr::vector<pmr::vector<const Person*>> groups(departmentNames().size() * kAgeGroupCount, in.arena);
+    
+    auto now = Clock::now();
+    
+    for (const auto& p : people) {
+        size_t slot = p.deptCode * kAgeGroupCount + (p.getAgeGroup() - kFirstAgeGroup) / 10;
+        groups[slot].push_back(&p);
+    }
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        const auto& group = groups[slot];
+        if (group.size() <= 5) continue;
+        
+        double totalSalary = 0.0;
+        double totalTenure = 0.0;
+        
+        for (const auto* p : group) {
+            totalSalary += p->salary;
+            totalTenure += static_cast<double>(duration_cast<Days>(now - p->hireDate).count());
+        }
+        
+        result.push_back(ageGroupStats(slot, group.size(), totalSalary, totalTenure));
+    }
+    return result;
+}
+
+// PersonProjection whose strings are views of characters in the arena, so
+// the sort moves plain values
+struct ArenaProjection {
+    int id;
+    string_view upperName;
+    size_t nameLength;
+    string_view formattedSalary;
+    bool isManager;
+};
+
+// Builds the sorted rows in the arena and hands them to finish before the
+// scope rewinds it
+template <typename Finish>
+auto stringOpsArena(const ArenaInput& in, Finish finish) {
+    const auto& people = *in.people;
+    ArenaScope scope(*in.arena);
+    
+    pmr::vector<ArenaProjection> result(in.arena);
+    result.reserve(people.size() / 10);
+    
+    for (const auto& p : people) {
+        if (p.name.find('a') == string::npos && p.name.find('e') == string::npos)
+            continue;
+            
+        if (p.name.size() <= 5) continue;
+        
+        // Both strings are allocated from the arena as well
+        auto* upper = static_cast<char*>(in.arena->allocate(p.name.size(), 1));
+        transform(p.name.begin(), p.name.end(), upper,
+            [](unsigned char c) { return static_cast<char>(toupper(c)); });
+        auto salary = formatSalary(p.salary);
+        auto* formatted = static_cast<char*>(in.arena->allocate(salary.size(), 1));
+        memcpy(formatted, salary.data(), salary.size());
+        
+        result.push_back(ArenaProjection{ p.id, string_view(upper, p.name.size()), p.name.size(),
+            string_view(formatted, salary.size()), isManager(p.name, p.salary) });
+    }
+    
+    sort(result.begin(), result.end(), [](const ArenaProjection& a, const ArenaProjection& b) {
+        int order = a.upperName.compare(b.upperName);
+        return order != 0 ? order < 0 : a.id < b.id;
+    });
+    return finish(result);
+}
+
+// The timed kernel stays allocation-free: the arena rows only go through
+// doNotOptimize(), and --verify copies them out with stringOpsArenaResult()
+size_t runStringOpsArena(const ArenaInput& in) {
+    return stringOpsArena(in, [](const pmr::vector<ArenaProjection>& rows) {
+        doNotOptimize(rows);
+        return rows.size();
+    });
+}
+
+vector<PersonProjection> stringOpsArenaResult(const ArenaInput& in) {
+    return stringOpsArena(in, [](const pmr::vector<ArenaProjection>& rows) {
+        vector<PersonProjection> result;
+        for (const auto& row : rows) {
+            result.push_back(PersonProjection{ row.id, string(row.upperName), row.nameLength,
+                string(row.formattedSalary), row.isManager });
+        }
+        return result;
+    });
+}
+
+vector<DepartmentAnalysis> runNestedArena(const ArenaInput& in) {
+    const auto& people = *in.people;
+    ArenaScope scope(*in.arena);
+    
+    pmr::vector<char> present(departmentNames().size(), 0, in.arena);
+    size_t departmentCount = 0;
+    
+    for (const auto& p : people) {
+        if (!present[p.deptCode]) {
+            present[p.deptCode] = 1;
+            departmentCount++;
+        }
+    }
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < present.size(); ++dept) {
+        if (!present[dept]) continue;
+        
+        pmr::vector<const Person*> group(in.arena);
+        group.reserve(people.size() / departmentCount);
+        
+        size_t highEarners = 0;
+        int64_t totalAge = 0;
+        
+        for (const auto& p : people) {
+            if (p.deptCode == dept) {
+                group.push_back(&p);
+                if (p.salary > 75000) highEarners++;
+                totalAge += p.age;
+            }
+        }
+        
+        if (group.size() > 50) {
+            double avgAge = static_cast<double>(totalAge) / static_cast<double>(group.size());
+            result.push_back(DepartmentAnalysis{ departmentNames()[dept], group.size(), highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+vector<YoungProfessional> runProjectionArena(const ArenaInput& in) {
+    const auto& people = *in.people;
+    ArenaScope scope(*in.arena);
+    
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    auto byHireDate = [](const Person* a, const Person* b) {
+        return a->hireDate < b->hireDate;
+    };
+    
+    using ArenaAlloc = pmr::polymorphic_allocator<const Person*>;
+    TopK<const Person*, decltype(byHireDate), ArenaAlloc> top(kProjectionLimit, byHireDate, ArenaAlloc(in.arena));
+    
+    for (const auto& p : people) {
+        if (p.hireDate > cutoff && p.age < 30 && p.salary > 60000) {
+            top.push(&p);
+        }
+    }
+    
+    vector<YoungProfessional> result;
+    for (const auto* p : top.take()) result.push_back(youngProfessional(*p, now));
+    return result;
+}
+
+// Push-based query pipelines in the style of LINQ and Java streams. from()
+// starts a pipeline over a range and `|` appends operators. where and select
+// only wrap the downstream consumer; a terminal operator (groupBy, aggregate,
+// topN, toVector) then runs a single loop over the source that pushes every
+// element through the whole fused chain. Nothing is materialized between
+// operators, so after inlining the loop matches a hand-written one.
+
+struct IdentityWrap {
+    template <typename Sink>
+    Sink operator()(Sink sink) const { return sink; }
+};
+
+// Elem is the type the last operator produces; Wrap turns a consumer of Elem
+// into a consumer of source elements
+template <typename Range, typename Elem, typename Wrap>
+struct Pipeline {
+    const Range* source;
+    Wrap wrap;
+    
+    template <typename Sink>
+    void run(Sink sink) const {
+        auto consumer = wrap(sink);
+        for (const auto& item : *source) consumer(item);
+    }
+};
+
+template <typename Range>
+auto from(const Range& range) {
+    using Elem = typename Range::value_type;
+    return Pipeline<Range, Elem, IdentityWrap>{ &range, {} };
+}
+
+template <typename Pred> struct WhereOp { Pred pred; };
+template <typename Fn> struct SelectOp { Fn fn; };
+
+template <typename Pred>
+WhereOp<Pred> where(Pred pred) { return { pred }; }
+
+template <typename Fn>
+SelectOp<Fn> select(Fn fn) { return { fn }; }
+
+template <typename Range, typename Elem, typename Wrap, typename Pred>
+auto operator|(const Pipeline<Range, Elem, Wrap>& pipeline, WhereOp<Pred> op) {
+    auto wrap = [inner = pipeline.wrap, pred = op.pred](auto sink) {
+        return inner([pred, sink](const Elem& item) mutable {
+            if (pred(item)) sink(item);
+        });
+    };
+    return Pipeline<Range, Elem, decltype(wrap)>{ pipeline.source, wrap };
+}
+
+template <typename Range, typename Elem, typename Wrap, typename Fn>
+auto operator|(const Pipeline<Range, Elem, Wrap>& pipeline, SelectOp<Fn> op) {
+    using Out = decay_t<invoke_result_t<Fn, const Elem&>>;
+    auto wrap = [inner = pipeline.wrap, fn = op.fn](auto sink) {
+        return inner([fn, sink](const Elem& item) mutable {
+            sink(fn(item));
+        });
+    };
+    return Pipeline<Range, Out, decltype(wrap)>{ pipeline.source, wrap };
+}
+
+// Terminal operators. groupBy folds into one accumulator per dense key in
+// [0, keyCount), aggregate into a single one.
+
+template <typename Key, typename Acc, typename Fold>
+struct GroupByOp {
+    size_t keyCount;
+    Key key;
+    Acc init;
+    Fold fold;
+};
+
+template <typename Acc, typename Fold>
+struct AggregateOp {
+    Acc init;
+    Fold fold;
+};
+
+template <typename Less> struct TopNOp { size_t k; Less less; };
+struct ToVectorOp { size_t capacity; };
+
+template <typename Key, typename Acc, typename Fold>
+GroupByOp<Key, Acc, Fold> groupBy(size_t keyCount, Key key, Acc init, Fold fold) { return { keyCount, key, init, fold }; }
+
+template <typename Acc, typename Fold>
+AggregateOp<Acc, Fold> aggregate(Acc init, Fold fold) { return { init, fold }; }
+
+template <typename Less>
+TopNOp<Less> topN(size_t k, Less less) { return { k, less }; }
+
+// capacity is only a reserve() hint
+inline ToVectorOp toVector(size_t capacity = 0) { return { capacity }; }
+
+template <typename Range, typename Elem, typename Wrap, typename Key, typename Acc, typename Fold>
+vector<Acc> operator|(const Pipeline<Range, Elem, Wrap>& pipeline, GroupByOp<Key, Acc, Fold> op) {
+    vector<Acc> groups(op.keyCount, op.init);
+    pipeline.run([&](const Elem& item) { op.fold(groups[op.key(item)], item); });
+    return groups;
+}
+
+template <typename Range, typename Elem, typename Wrap, typename Acc, typename Fold>
+Acc operator|(const Pipeline<Range, Elem, Wrap>& pipeline, AggregateOp<Acc, Fold> op) {
+    Acc acc = op.init;
+    pipeline.run([&](const Elem& item) { op.fold(acc, item); });
+    return acc;
+}
+
+// The k smallest elements under less, in ascending order
+template <typename Range, typename Elem, typename Wrap, typename Less>
+vector<Elem> operator|(const Pipeline<Range, Elem, Wrap>& pipeline, TopNOp<Less> op) {
+    TopK<Elem, Less> top(op.k, op.less);
+    pipeline.run([&](const Elem& item) { top.push(item); });
+    return top.take();
+}
+
+template <typename Range, typename Elem, typename Wrap>
+vector<Elem> operator|(const Pipeline<Range, Elem, Wrap>& pipeline, ToVectorOp op) {
+    vector<Elem> result;
+    result.reserve(op.capacity);
+    pipeline.run([&](const Elem& item) { result.push_back(item); });
+    return result;
+}
+
+// The five tests written as pipelines. Where the hand-written kernels sort
+// rows before grouping, the pipelines fold straight into the groups: the
+// order inside a group does not change its count, max or min, and moves the
+// average only by rounding.
+
+vector<DepartmentStats> runComplexOperationsPipeline(const vector<Person>& people) {
+    const auto& departments = departmentNames();
+    auto groups = from(people)
+        | where([](const Person& p) { return p.age > 25 && p.salary > 50000; })
+        | groupBy(departments.size(), [](const Person& p) { return p.deptCode; }, SalaryStats{},
+            [](SalaryStats& acc, const Person& p) {
+                acc.count++;
+                acc.totalSalary += p.salary;
+                acc.maxSalary = max(acc.maxSalary, p.salary);
+                acc.minAge = min(acc.minAge, p.age);
+            });
+    
+    vector<DepartmentStats> stats;
+    for (size_t code = 0; code < groups.size(); ++code) {
+        const auto& acc = groups[code];
+        if (acc.count <= 10) continue;
+        stats.push_back(DepartmentStats{ departments[code], acc.count, acc.totalSalary / static_cast<double>(acc.count), acc.maxSalary, acc.minAge });
+    }
+    
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> runGroupByPipeline(const vector<Person>& people) {
+    auto now = Clock::now();
+    auto groups = from(people)
+        | groupBy(departmentNames().size() * kAgeGroupCount,
+            [](const Person& p) { return p.deptCode * kAgeGroupCount + (p.age / 10 - kFirstAgeGroup / 10); }, TenureStats{},
+            [now](TenureStats& acc, const Person& p) {
+                acc.count++;
+                acc.totalSalary += p.salary;
+                acc.totalTenure += static_cast<double>(duration_cast<Days>(now - p.hireDate).count());
+            });
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        const auto& acc = groups[slot];
+        if (acc.count > 5) result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure));
+    }
+    return result;
+}
+
+vector<PersonProjection> runStringOpsPipeline(const vector<Person>& people) {
+    auto result = from(people)
+        | where([](const Person& p) {
+            return (p.name.find('a') != string::npos || p.name.find('e') != string::npos) && p.name.size() > 5;
+        })
+        | select([](const Person& p) {
+            string upper(p.name);
+            transform(upper.begin(), upper.end(), upper.begin(),
+                [](unsigned char c) { return static_cast<char>(toupper(c)); });
+            return personProjection(p.id, move(upper), p.name, p.salary);
+        })
+        | toVector(people.size() / 10);
+    
+    // Ordering needs every element, so the sort stays outside the fused loop
+    sortProjections(result);
+    return result;
+}
+
+vector<DepartmentAnalysis> runNestedPipeline(const vector<Person>& people) {
+    auto groups = from(people)
+        | groupBy(departmentNames().size(), [](const Person& p) { return p.deptCode; }, Headcount{},
+            [](Headcount& acc, const Person& p) {
+                acc.employees++;
+                if (p.salary > 75000) acc.highEarners++;
+                acc.totalAge += p.age;
+            });
+    
+    vector<DepartmentAnalysis> result;
+    for (size_t dept = 0; dept < groups.size(); ++dept) {
+        const auto& acc = groups[dept];
+        if (acc.employees > 50) {
+            double avgAge = static_cast<double>(acc.totalAge) / static_cast<double>(acc.employees);
+            result.push_back(DepartmentAnalysis{ departmentNames()[dept], acc.employees, acc.highEarners, avgAge });
+        }
+    }
+    
+    sortDepartmentAnalysis(result);
+    return result;
+}
+
+vector<YoungProfessional> runProjectionPipeline(const vector<Person>& people) {
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    auto top = from(people)
+        | where([cutoff](const Person& p) { return p.hireDate > cutoff && p.age < 30 && p.salary > 60000; })
+        | select([](const Person& p) { return &p; })
+        | topN(kProjectionLimit, [](const Person* a, const Person* b) { return a->hireDate < b->hireDate; });
+    
+    vector<YoungProfessional> result;
+    for (const auto* p : top) result.push_back(youngProfessional(*p, now));
+    return result;
+}
+
+// Runs the five row kernels over each name layout and prints their memory footprint
+void measureNameLayouts(const vector<Person>& people) {
+    auto startInline = high_resolution_clock::now();
+    auto inlineRows = toInlineLayout(people);
+    auto startPooled = high_resolution_clock::now();
+    auto pooled = toPooledLayout(people);
+    auto end = high_resolution_clock::now();
+    
+    const auto& pooledRows = pooled.rows;
+    auto megabytes = [](size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    
+    g_results.section = "Name Storage Layouts";
+    cout << "\nName Storage Layouts:\n========================\n" << fixed << setprecision(2)
+         << setw(kLabelWidth) << left << "std::string rows" << ": " << sizeof(Person) << " bytes/row, "
+         << megabytes(footprint(people)) << "MB\n"
+         << setw(kLabelWidth) << left << "inline name rows" << ": " << sizeof(InlinePerson) << " bytes/row, "
+         << megabytes(footprint(inlineRows)) << "MB, built in "
+         << duration<double, milli>(startPooled - startInline).count() << "ms\n"
+         << setw(kLabelWidth) << left << "pooled name rows" << ": " << sizeof(PooledPerson) << " bytes/row, "
+         << megabytes(footprint(pooled)) << "MB, built in "
+         << duration<double, milli>(end - startPooled).count() << "ms\n\n";
+    
+    struct Timings {
+        Timing strings;
+        Timing inlined;
+        Timing pooled;
+    };
+    
+    auto report = [](const string& label, const Timings& t) {
+        printTiming(label + " [std::string]", t.strings);
+        printTiming(label + " [inline]", t.inlined, &t.strings);
+        printTiming(label + " [pooled]", t.pooled, &t.strings);
+    };
+    
+    report("Complex LINQ Chain", { measure(people, runComplexOperations<Person>),
+        measure(inlineRows, runComplexOperations<InlinePerson>), measure(pooledRows, runComplexOperations<PooledPerson>) });
+    report("GroupBy with Aggregation", { measure(people, runGroupBy<Person>),
+        measure(inlineRows, runGroupBy<InlinePerson>), measure(pooledRows, runGroupBy<PooledPerson>) });
+    report("String Operations", { measure(people, runStringOps<Person>),
+        measure(inlineRows, runStringOps<InlinePerson>), measure(pooledRows, runStringOps<PooledPerson>) });
+    report("Nested Queries", { measure(people, runNested<Person>),
+        measure(inlineRows, runNested<InlinePerson>), measure(pooledRows, runNested<PooledPerson>) });
+    report("Projection with Where", { measure(people, runProjection<Person>),
+        measure(inlineRows, runProjection<InlinePerson>), measure(pooledRows, runProjection<PooledPerson>) });
+}
+
+// Compares the regular heap-backed row kernels with their arena versions
+void measureArena(const vector<Person>& people) {
+    g_results.section = "Arena Allocator";
+    cout << "\nArena Allocator:\n========================\n";
+    
+    auto compare = [&](const string& label, auto heapOp, auto arenaOp) {
+        Arena arena;
+        auto heap = measure(people, heapOp);
+        auto pooled = measure(ArenaInput{ &people, &arena }, arenaOp);
+        
+        printTiming(label + " [heap]", heap);
+        printTiming(label + " [arena]", pooled, &heap);
+    };
+    
+    compare("Complex LINQ Chain", runComplexOperations<Person>, runComplexOperationsArena);
+    compare("GroupBy with Aggregation", runGroupBy<Person>, runGroupByArena);
+    compare("String Operations", runStringOps<Person>, runStringOpsArena);
+    compare("Nested Queries", runNested<Person>, runNestedArena);
+    compare("Projection with Where", runProjection<Person>, runProjectionArena);
+}
+
+// Times the hand-written row kernels against their pipeline versions
+void measurePipelines(const vector<Person>& people) {
+    g_results.section = "Pipelines";
+    cout << "\nPipelines:\n========================\n";
+    
+    auto compare = [&](const string& label, auto handOp, auto pipelineOp) {
+        auto handWritten = measure(people, handOp);
+        auto fused = measure(people, pipelineOp);
+        
+        printTiming(label + " [hand]", handWritten);
+        printTiming(label + " [pipeline]", fused, &handWritten);
+    };
+    
+    compare("Complex LINQ Chain", runComplexOperations<Person>, runComplexOperationsPipeline);
+    compare("GroupBy with Aggregation", runGroupBy<Person>, runGroupByPipeline);
+    compare("String Operations", runStringOps<Person>, runStringOpsPipeline);
+    compare("Nested Queries", runNestedSinglePass<Person>, runNestedPipeline);
+    compare("Projection with Where", runProjection<Person>, runProjectionPipeline);
+}
+
+// Streaming versions of the five tests for datasets that are never held in
+// memory at once. Each consumer reduces a chunk to a partial state and merges
+// it into its running total; finish() turns the total into the test result.
+// Only the String Operations output grows with the row count, because that
+// output is the query result itself.
+
+// Test results from fully merged accumulators, shared with the NUMA kernels
+vector<DepartmentStats> departmentStats(const array<SalaryStats, kDepartmentCount>& total) {
+    vector<DepartmentStats> stats;
+    for (size_t code = 0; code < kDepartmentCount; ++code) {
+        const auto& acc = total[code];
+        if (acc.count <= 10) continue;
+        stats.push_back(DepartmentStats{ departmentNames()[code], acc.count, acc.totalSalary / static_cast<double>(acc.count), acc.maxSalary, acc.minAge });
+    }
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> ageGroupStats(const FlatGroups<DeptAgeDomain, TenureStats>& total) {
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < total.slots.size(); ++slot) {
+        const auto& acc = total.slots[slot];
+        if (acc.count > 5) result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure));
+    }
+    return result;
+}
+
+vector<DepartmentAnalysis> departmentAnalysis(const array<Headcount, kDepartmentCount>& total) {
+    vector<DepartmentAnalysis> analysis;
+    for (size_t code = 0; code < kDepartmentCount; ++code) {
+        const auto& acc = total[code];
+        if (acc.employees <= 50) continue;
+        analysis.push_back(DepartmentAnalysis{ departmentNames()[code], acc.employees, acc.highEarners,
+            static_cast<double>(acc.totalAge) / static_cast<double>(acc.employees) });
+    }
+    sortDepartmentAnalysis(analysis);
+    return analysis;
+}
+
+// k-way merge of sorted runs into one sorted vector; the runs are consumed
+vector<PersonProjection> mergeSortedRuns(vector<vector<PersonProjection>>& runs) {
+    using Cursor = pair<size_t, size_t>; // (run, position)
+    auto greater = [&](const Cursor& a, const Cursor& b) {
+        return byUpperName(runs[b.first][b.second], runs[a.first][a.second]);
+    };
+    priority_queue<Cursor, vector<Cursor>, decltype(greater)> heads(greater);
+    
+    size_t total = 0;
+    for (size_t r = 0; r < runs.size(); ++r) {
+        total += runs[r].size();
+        if (!runs[r].empty()) heads.push({ r, 0 });
+    }
+    
+    vector<PersonProjection> merged;
+    merged.reserve(total);
+    while (!heads.empty()) {
+        auto [r, i] = heads.top();
+        heads.pop();
+        merged.push_back(move(runs[r][i]));
+        if (i + 1 < runs[r].size()) heads.push({ r, i + 1 });
+    }
+    runs.clear();
+    return merged;
+}
+
+struct StreamingComplex {
+    array<SalaryStats, kDepartmentCount> total{};
+    
+    void consume(const vector<Person>& chunk) {
+        array<SalaryStats, kDepartmentCount> partial{};
+        for (const auto& p : chunk) {
+            if (p.age <= 25 || p.salary <= 50000) continue;
+            auto& acc = partial[p.deptCode];
+            acc.count++;
+            acc.totalSalary += p.salary;
+            acc.maxSalary = max(acc.maxSalary, p.salary);
+            acc.minAge = min(acc.minAge, p.age);
+        }
+        for (size_t code = 0; code < kDepartmentCount; ++code) total[code].merge(partial[code]);
+    }
+    
+    vector<DepartmentStats> finish() const { return departmentStats(total); }
+};
+
+struct StreamingGroupBy {
+    Clock::time_point now = Clock::now();
+    FlatGroups<DeptAgeDomain, TenureStats> total;
+    
+    void consume(const vector<Person>& chunk) {
+        FlatGroups<DeptAgeDomain, TenureStats> partial;
+        for (const auto& p : chunk) {
+            auto& acc = partial(p.deptCode, p.age / 10 - kFirstAgeGroup / 10);
+            acc.count++;
+            acc.totalSalary += p.salary;
+            acc.totalTenure += static_cast<double>(duration_cast<Days>(now - p.hireDate).count());
+        }
+        for (size_t i = 0; i < DeptAgeDomain::size; ++i) total.slots[i].merge(partial.slots[i]);
+    }
+    
+    vector<AgeGroupStats> finish() const { return ageGroupStats(total); }
+};
+
+// Every chunk becomes one sorted run; finish() k-way merges the runs
+struct StreamingStringOps {
+    vector<vector<PersonProjection>> runs;
+    
+    void consume(const vector<Person>& chunk) {
+        vector<PersonProjection> run;
+        for (const auto& p : chunk) {
+            if (p.name.find('a') == string::npos && p.name.find('e') == string::npos) continue;
+            if (p.name.size() <= 5) continue;
+            
+            string upper(p.name);
+            transform(upper.begin(), upper.end(), upper.begin(),
+                [](unsigned char c) { return static_cast<char>(toupper(c)); });
+            run.push_back(personProjection(p.id, move(upper), p.name, p.salary));
+        }
+        sortProjections(run);
+        runs.push_back(move(run));
+    }
+    
+    vector<PersonProjection> finish() { return mergeSortedRuns(runs); }
+};
+
+struct StreamingNested {
+    array<Headcount, kDepartmentCount> total{};
+    
+    void consume(const vector<Person>& chunk) {
+        array<Headcount, kDepartmentCount> partial{};
+        for (const auto& p : chunk) {
+            auto& acc = partial[p.deptCode];
+            acc.employees++;
+            if (p.salary > 75000) acc.highEarners++;
+            acc.totalAge += p.age;
+        }
+        for (size_t code = 0; code < kDepartmentCount; ++code) total[code].merge(partial[code]);
+    }
+    
+    vector<DepartmentAnalysis> finish() const { return departmentAnalysis(total); }
+};
+
+// Keeps copies: the chunk a row came from is gone by the time finish() runs
+struct StreamingProjection {
+    static bool byHireDate(const Person& a, const Person& b) { return a.hireDate < b.hireDate; }
+    
+    Clock::time_point now = Clock::now();
+    Clock::time_point cutoff = now - Days(static_cast<int>(365.25 * 5));
+    TopK<Person, bool(*)(const Person&, const Person&)> total{ kProjectionLimit, byHireDate };
+    
+    void consume(const vector<Person>& chunk) {
+        auto lessPtr = [](const Person* a, const Person* b) { return a->hireDate < b->hireDate; };
+        TopK<const Person*, decltype(lessPtr)> partial(kProjectionLimit, lessPtr);
+        for (const auto& p : chunk) {
+            if (p.hireDate > cutoff && p.age < 30 && p.salary > 60000) partial.push(&p);
+        }
+        for (const auto* p : partial.take()) total.push(*p);
+    }
+    
+    vector<YoungProfessional> finish() {
+        vector<YoungProfessional> result;
+        for (const auto& p : total.take()) result.push_back(youngProfessional(p, now));
+        return result;
+    }
+};
+
+// Fills chunk with the next rows of a streaming run; false once there are none
+using ChunkLoader = function<bool(vector<Person>&)>;
+
+// Feeds every chunk the loader produces to the five streaming consumers, so
+// only a few chunks of rows are alive at a time. With queueDepth 0 loading and
+// consuming alternate on this thread. Otherwise a loader thread runs up to
+// queueDepth chunks ahead while the consumers fold the current one, and waits
+// when the queue is full.
+void measureStreaming(const ChunkLoader& load, const string& loadLabel, size_t chunkRows, size_t queueDepth) {
+    vector<Person> chunk;
+    
+    StreamingComplex complex;
+    StreamingGroupBy groupBy;
+    StreamingStringOps strings;
+    StreamingNested nested;
+    StreamingProjection projection;
+    
+    struct Stage {
+        const char* label;
+        function<void()> consume;
+        function<void()> finish;
+        duration<double, milli> elapsed{};
+        duration<double, milli> slowestChunk{};
+    };
+    
+    vector<Stage> stages = {
+        { "Complex LINQ Chain", [&] { complex.consume(chunk); }, [&] { doNotOptimize(complex.finish()); } },
+        { "GroupBy with Aggregation", [&] { groupBy.consume(chunk); }, [&] { doNotOptimize(groupBy.finish()); } },
+        { "String Operations", [&] { strings.consume(chunk); }, [&] { doNotOptimize(strings.finish()); } },
+        { "Nested Queries", [&] { nested.consume(chunk); }, [&] { doNotOptimize(nested.finish()); } },
+        { "Projection with Where", [&] { projection.consume(chunk); }, [&] { doNotOptimize(projection.finish()); } },
+    };
+    
+    size_t rows = 0, chunks = 0;
+    auto consumeChunk = [&] {
+        for (auto& stage : stages) {
+            auto begin = high_resolution_clock::now();
+            stage.consume();
+            duration<double, milli> spent = high_resolution_clock::now() - begin;
+            stage.elapsed += spent;
+            stage.slowestChunk = max(stage.slowestChunk, spent);
+        }
+        rows += chunk.size();
+        chunks++;
+    };
+    
+    duration<double, milli> loading{}, starved{}, blocked{};
+    auto wallStart = high_resolution_clock::now();
+    
+    if (queueDepth == 0) {
+        for (;;) {
+            auto start = high_resolution_clock::now();
+            bool more = load(chunk);
+            loading += high_resolution_clock::now() - start;
+            if (!more) break;
+            consumeChunk();
+        }
+    } else {
+        // Buffers cycle loader -> ready -> consumers -> spare -> loader, so no
+        // more than queueDepth + 2 chunks exist at once
+        BoundedQueue<vector<Person>> ready(queueDepth), spare(queueDepth + 2);
+        for (size_t i = 0; i < queueDepth + 2; ++i) spare.push({});
+        
+        exception_ptr failure;
+        thread loader([&] {
+            try {
+                vector<Person> buffer;
+                for (;;) {
+                    auto waitStart = high_resolution_clock::now();
+                    if (!spare.pop(buffer)) break;
+                    auto start = high_resolution_clock::now();
+                    bool more = load(buffer);
+                    auto end = high_resolution_clock::now();
+                    loading += end - start;
+                    if (!more || !ready.push(move(buffer))) break;
+                    blocked += (start - waitStart) + (high_resolution_clock::now() - end);
+                }
+            } catch (...) {
+                failure = current_exception();
+            }
+            ready.close();
+        });
+        
+        // If a consumer throws, the loader may be waiting on either queue.
+        // Closing both releases it, so it can be joined before unwinding.
+        struct LoaderGuard {
+            thread& loader;
+            BoundedQueue<vector<Person>>& ready;
+            BoundedQueue<vector<Person>>& spare;
+            
+            ~LoaderGuard() {
+                ready.close();
+                spare.close();
+                if (loader.joinable()) loader.join();
+            }
+        } guard{ loader, ready, spare };
+        
+        for (;;) {
+            auto waitStart = high_resolution_clock::now();
+            bool more = ready.pop(chunk);
+            starved += high_resolution_clock::now() - waitStart;
+            if (!more) break;
+            consumeChunk();
+            spare.push(move(chunk));
+        }
+        loader.join();
+        if (failure) rethrow_exception(failure);
+    }
+    
+    for (auto& stage : stages) {
+        auto begin = high_resolution_clock::now();
+        stage.finish();
+        stage.elapsed += high_resolution_clock::now() - begin;
+    }
+    duration<double, milli> wall = high_resolution_clock::now() - wallStart;
+    
+    g_results.section = "Streaming";
+    cout << "Streaming " << rows << " rows in " << chunks << " chunks of " << chunkRows;
+    if (queueDepth > 0) cout << ", loading overlapped up to " << queueDepth << (queueDepth == 1 ? " chunk" : " chunks") << " ahead";
+    cout << ":\n========================\n" << fixed << setprecision(2);
+    cout << setw(kLabelWidth) << left << loadLabel << ": " << loading.count() << "ms"
+         << (queueDepth > 0 ? " on the loader thread\n" : "\n");
+    if (queueDepth > 0) {
+        cout << setw(kLabelWidth) << left << "Consumers waiting for a chunk" << ": " << starved.count() << "ms\n";
+        cout << setw(kLabelWidth) << left << "Loader waiting on a full queue" << ": " << blocked.count() << "ms\n";
+    }
+    cout << setw(kLabelWidth) << left << "Wall time" << ": " << wall.count() << "ms\n";
+    for (const auto& stage : stages) {
+        cout << setw(kLabelWidth) << left << stage.label << ": Total: " << fixed << setprecision(2)
+             << stage.elapsed.count() << "ms, " << stage.elapsed.count() * 1e6 / static_cast<double>(rows) << "ns/row"
+             << ", Slowest chunk: " << stage.slowestChunk.count() << "ms\n";
+    }
+}
+
+// --stream: chunks come from the generator, or are copied out of the mapped
+// --data file while the OS reads the chunk after them ahead
+void runStreaming(const string& dataPath, size_t rows, size_t chunkRows, size_t queueDepth, const GeneratorOptions& generatorOptions) {
+    size_t done = 0;
+    if (dataPath.empty()) {
+        PersonGenerator generator(generatorOptions);
+        g_results.rows = rows;
+        measureStreaming([&](vector<Person>& chunk) {
+            if (done >= rows) return false;
+            generator.generate(chunk, static_cast<int>(min(chunkRows, rows - done)));
+            done += chunk.size();
+            return true;
+        }, "Generation", chunkRows, queueDepth);
+        return;
+    }
+    
+    auto table = mapDataset(dataPath);
+    g_results.rows = table.size();
+    measureStreaming([&](vector<Person>& chunk) {
+        if (done >= table.size()) return false;
+        size_t end = min(table.size(), done + chunkRows);
+        adviseWillNeed(table, end, min(table.size(), end + chunkRows));
+        toRows(table, done, end, chunk);
+        done = end;
+        return true;
+    }, "Load from " + dataPath, chunkRows, queueDepth);
+}
+
+// Materialized results of the Complex Operations (per department, over the
+// filtered rows) and GroupBy (per department and age group) tests, kept
+// current under insert and erase instead of being recomputed from the whole
+// table. Counts and sums are updated in place. Max salary and min age cannot
+// be undone by subtraction, so every department also keeps its salaries and
+// ages in ordered multisets that give the new extreme after an erase.
+class IncrementalStats {
+public:
+    void insert(const Person& p) {
+        auto& slot = slots[DeptAgeDomain::index(p.deptCode, p.age / 10 - kFirstAgeGroup / 10)];
+        slot.count++;
+        slot.totalSalary += p.salary;
+        slot.totalHireDay += epochDay(p.hireDate);
+        
+        if (!passesComplexFilter(p)) return;
+        auto& dept = departments[p.deptCode];
+        dept.totalSalary += p.salary;
+        dept.salaries.insert(p.salary);
+        dept.ages.insert(p.age);
+    }
+    
+    // p must be equal to a row inserted before
+    void erase(const Person& p) {
+        auto& slot = slots[DeptAgeDomain::index(p.deptCode, p.age / 10 - kFirstAgeGroup / 10)];
+        if (slot.count == 0) throw invalid_argument("erase of a row that was never inserted");
+        slot.count--;
+        slot.totalSalary -= p.salary;
+        slot.totalHireDay -= epochDay(p.hireDate);
+        
+        if (!passesComplexFilter(p)) return;
+        auto& dept = departments[p.deptCode];
+        auto salary = dept.salaries.find(p.salary);
+        auto age = dept.ages.find(p.age);
+        if (salary == dept.salaries.end() || age == dept.ages.end()) throw invalid_argument("erase of a row that was never inserted");
+        dept.salaries.erase(salary);
+        dept.ages.erase(age);
+        dept.totalSalary -= p.salary;
+    }
+    
+    // Same result as runComplexOperations() over the current rows
+    vector<DepartmentStats> departmentStats() const {
+        vector<DepartmentStats> stats;
+        for (size_t code = 0; code < kDepartmentCount; ++code) {
+            const auto& dept = departments[code];
+            size_t count = dept.salaries.size();
+            if (count <= 10) continue;
+            stats.push_back(DepartmentStats{ departmentNames()[code], count, dept.totalSalary / static_cast<double>(count),
+                *dept.salaries.rbegin(), *dept.ages.begin() });
+        }
+        sortDepartmentStats(stats);
+        return stats;
+    }
+    
+    // Same result as runGroupByDaysSoA() over the current rows
+    vector<AgeGroupStats> groupStats(int32_t today) const {
+        vector<AgeGroupStats> result;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const auto& slot = slots[i];
+            if (slot.count <= 5) continue;
+            auto totalTenure = static_cast<double>(static_cast<int64_t>(slot.count) * today - slot.totalHireDay);
+            result.push_back(ageGroupStats(i, slot.count, slot.totalSalary, totalTenure));
+        }
+        return result;
+    }
+    
+private:
+    static bool passesComplexFilter(const Person& p) { return p.age > 25 && p.salary > 50000; }
+    
+    struct Department {
+        double totalSalary = 0;
+        multiset<double> salaries;
+        multiset<int> ages;
+    };
+    
+    struct Slot {
+        size_t count = 0;
+        double totalSalary = 0;
+        int64_t totalHireDay = 0;
+    };
+    
+    array<Department, kDepartmentCount> departments;
+    array<Slot, DeptAgeDomain::size> slots{};
+};
+
+// Slides a window over the data: every step appends batchRows new rows and
+// expires the oldest batchRows, then brings the Complex Operations and GroupBy
+// results up to date, once through IncrementalStats and once by rerunning the
+// row kernels over the whole window
+void measureIncremental(const vector<Person>& people, size_t batchRows, const GeneratorOptions& generatorOptions) {
+    constexpr int kSteps = 10;
+    
+    auto buildStart = high_resolution_clock::now();
+    IncrementalStats store;
+    for (const auto& p : people) store.insert(p);
+    auto buildEnd = high_resolution_clock::now();
+    
+    // Appended rows continue the dataset's own stream with new ids; a fresh
+    // generator would re-draw exactly the rows each step expires
+    auto window = people;
+    PersonGenerator incoming(generatorOptions);
+    incoming.skip(people.size());
+    for (const auto& p : people) incoming.continueIdsAfter(p.id);
+    vector<Person> batch;
+    vector<double> incremental, full;
+    size_t incrementalAllocations = 0, fullAllocations = 0;
+    size_t incrementalBytes = 0, fullBytes = 0;
+    
+    for (int step = 0; step < kSteps; ++step) {
+        incoming.generate(batch, static_cast<int>(batchRows));
+        const size_t expired = min(batchRows, window.size());
+        
+        auto allocationsBefore = g_allocationCount.load();
+        auto bytesBefore = g_allocatedBytes.load();
+        auto start = high_resolution_clock::now();
+        for (const auto& p : batch) store.insert(p);
+        for (size_t i = 0; i < expired; ++i) store.erase(window[i]);
+        auto stats = store.departmentStats();
+        doNotOptimize(stats);
+        auto groups = store.groupStats(epochDay(Clock::now()));
+        doNotOptimize(groups);
+        auto end = high_resolution_clock::now();
+        incrementalAllocations += g_allocationCount.load() - allocationsBefore;
+        incrementalBytes += g_allocatedBytes.load() - bytesBefore;
+        incremental.push_back(duration<double, milli>(end - start).count());
+        
+        window.erase(window.begin(), window.begin() + static_cast<ptrdiff_t>(expired));
+        window.insert(window.end(), batch.begin(), batch.end());
+        
+        allocationsBefore = g_allocationCount.load();
+        bytesBefore = g_allocatedBytes.load();
+        start = high_resolution_clock::now();
+        auto recomputed = runComplexOperations(window);
+        doNotOptimize(recomputed);
+        auto regrouped = runGroupBy(window);
+        doNotOptimize(regrouped);
+        end = high_resolution_clock::now();
+        fullAllocations += g_allocationCount.load() - allocationsBefore;
+        fullBytes += g_allocatedBytes.load() - bytesBefore;
+        full.push_back(duration<double, milli>(end - start).count());
+    }
+    
+    auto summarize = [](const vector<double>& samples, size_t allocations, size_t bytes) {
+        auto runs = static_cast<double>(samples.size());
+        return summarizeRuns(samples, static_cast<double>(allocations) / runs, static_cast<double>(bytes) / runs);
+    };
+    
+    g_results.section = "Incremental Aggregates";
+    cout << "\nIncremental Aggregates (" << batchRows << "-row batches over " << people.size() << " rows):\n========================\n";
+    if (!sameDepartmentStats(store.departmentStats(), runComplexOperations(window))) {
+        cout << "Incremental department stats do not match a full recompute\n";
+    }
+    
+    cout << setw(kLabelWidth) << left << "Initial build" << ": " << fixed << setprecision(2)
+         << duration<double, milli>(buildEnd - buildStart).count() << "ms\n";
+    
+    auto fullTiming = summarize(full, fullAllocations, fullBytes);
+    printTiming("Append + expire batch [recompute]", fullTiming);
+    printTiming("Append + expire batch [incremental]", summarize(incremental, incrementalAllocations, incrementalBytes), &fullTiming);
+}
+
+// Secondary indexes: the row numbers of one column in ascending value order,
+// built once per dataset. A range predicate on the indexed column becomes a
+// binary search, and walking the index visits the rows in column order.
+uint64_t orderedKey(int value) { return static_cast<uint32_t>(value) ^ 0x8000'0000u; }
+uint64_t orderedKey(double value) { return orderedBits(value); }
+uint64_t orderedKey(system_clock::time_point value) {
+    return static_cast<uint64_t>(value.time_since_epoch().count()) ^ (uint64_t(1) << 63);
+}
+
+template <typename T>
+struct SortedIndex {
+    // Column values in ascending order, next to the row each one came from
+    vector<T> keys;
+    vector<uint32_t> rows;
+    
+    SortedIndex() = default;
+    
+    // Sorted with the LSD radix sort, so rows with equal values stay in row order
+    explicit SortedIndex(const Column<T>& column) {
+        vector<RadixKey> items(column.size());
+        for (size_t i = 0; i < column.size(); ++i) {
+            items[i] = RadixKey{ orderedKey(column[i]), static_cast<uint32_t>(i), 0 };
+        }
+        radixSortKeys(items);
+        
+        keys.resize(items.size());
+        rows.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            rows[i] = items[i].row;
+            keys[i] = column[rows[i]];
+        }
+    }
+    
+    size_t size() const { return keys.size(); }
+    
+    // First position whose value is not less than value
+    size_t lowerBound(T value) const {
+        return static_cast<size_t>(lower_bound(keys.begin(), keys.end(), value) - keys.begin());
+    }
+    
+    // First position whose value is greater than value
+    size_t upperBound(T value) const {
+        return static_cast<size_t>(upper_bound(keys.begin(), keys.end(), value) - keys.begin());
+    }
+};
+
+// One index per column the Complex and Projection predicates range over
+struct TableIndexes {
+    SortedIndex<int> age;
+    SortedIndex<double> salary;
+    SortedIndex<system_clock::time_point> hireDate;
+};
+
+struct IndexInput {
+    const PersonTable* table;
+    const TableIndexes* indexes;
+};
+
+SortedIndex<int> buildAgeIndex(const PersonTable& table) { return SortedIndex<int>(table.age); }
+SortedIndex<double> buildSalaryIndex(const PersonTable& table) { return SortedIndex<double>(table.salary); }
+SortedIndex<system_clock::time_point> buildHireDateIndex(const PersonTable& table) {
+    return SortedIndex<system_clock::time_point>(table.hireDate);
+}
+
+// Complex chain through the salary index. Walking it down from the top yields
+// the salary > 50,000 rows in salary-descending order, so appending each one
+// to its department's list replaces the sort by (department, salary).
+vector<DepartmentStats> runComplexOperationsSalaryIndex(const IndexInput& in) {
+    const auto& table = *in.table;
+    const auto& index = in.indexes->salary;
+    
+    vector<vector<uint32_t>> grouped(table.departmentDict.size());
+    for (size_t i = index.size(), end = index.upperBound(50000); i-- > end;) {
+        auto row = index.rows[i];
+        if (table.age[row] > 25) grouped[table.department[row]].push_back(row);
+    }
+    
+    return summarizeDepartments(table, grouped);
+}
+
+// The Projection test as a full scan, returning its rows for the index checks
+vector<uint32_t> runProjectionScan(const IndexInput& in) {
+    const auto& table = *in.table;
+    Selection filtered(table.size());
+    filtered.size = g_filters.projection(table, projectionCutoff(), filtered.rows.get());
+    
+    auto byHireDate = [&](uint32_t a, uint32_t b) {
+        return table.hireDate[a] < table.hireDate[b];
+    };
+    
+    TopK<uint32_t, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    for (uint32_t row : filtered) top.push(row);
+    return top.take();
+}
+
+// Projection through the age index: age < 30 is a prefix of it, about a fifth
+// of the rows, and only those are checked and fed to the top-N
+vector<uint32_t> runProjectionAgeIndex(const IndexInput& in) {
+    const auto& table = *in.table;
+    const auto& index = in.indexes->age;
+    auto cutoff = system_clock::time_point(system_clock::duration(projectionCutoff()));
+    
+    auto byHireDate = [&](uint32_t a, uint32_t b) {
+        return table.hireDate[a] < table.hireDate[b];
+    };
+    
+    TopK<uint32_t, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    for (size_t i = 0, end = index.lowerBound(30); i < end; ++i) {
+        auto row = index.rows[i];
+        if (table.hireDate[row] > cutoff && table.salary[row] > 60000) top.push(row);
+    }
+    return top.take();
+}
+
+// Projection through the hire date index. Its order is the result order, so
+// the walk starts at the cutoff and stops at the 1,000th qualifying row.
+vector<uint32_t> runProjectionHireDateIndex(const IndexInput& in) {
+    const auto& table = *in.table;
+    const auto& index = in.indexes->hireDate;
+    auto cutoff = system_clock::time_point(system_clock::duration(projectionCutoff()));
+    
+    vector<uint32_t> result;
+    result.reserve(kProjectionLimit);
+    for (size_t i = index.upperBound(cutoff); i < index.size() && result.size() < kProjectionLimit; ++i) {
+        auto row = index.rows[i];
+        if (table.age[row] < 30 && table.salary[row] > 60000) result.push_back(row);
+    }
+    return result;
+}
+
+// Many rows share a hire date, so two correct top-N results may pick different
+// rows at the boundary; they must still agree on the hire dates
+bool sameHireDates(const PersonTable& table, const vector<uint32_t>& a, const vector<uint32_t>& b) {
+    return equal(a.begin(), a.end(), b.begin(), b.end(), [&](uint32_t x, uint32_t y) {
+        return table.hireDate[x] == table.hireDate[y];
+    });
+}
+
+// An index pays for itself once the time it saves per query covers its build
+void printBreakEven(const Timing& build, const Timing& scan, const Timing& indexed) {
+    cout << setw(kLabelWidth) << left << "  break-even" << ": ";
+    if (indexed.avg < scan.avg) {
+        auto queries = static_cast<long long>(ceil(build.avg / (scan.avg - indexed.avg)));
+        cout << queries << (queries == 1 ? " query\n" : " queries\n");
+    } else {
+        cout << "never, the index is not faster\n";
+    }
+}
+
+// Times building each index, then the Complex and Projection tests as a full
+// column scan and through the indexes, with the break-even query count
+void measureIndexes(const PersonTable& table) {
+    g_results.section = "Secondary Indexes";
+    cout << "\nSecondary Indexes:\n========================\n";
+    
+    auto ageBuild = measure(table, buildAgeIndex);
+    auto salaryBuild = measure(table, buildSalaryIndex);
+    auto hireDateBuild = measure(table, buildHireDateIndex);
+    printTiming("Build age index", ageBuild);
+    printTiming("Build salary index", salaryBuild);
+    printTiming("Build hireDate index", hireDateBuild);
+    
+    TableIndexes indexes{ buildAgeIndex(table), buildSalaryIndex(table), buildHireDateIndex(table) };
+    IndexInput input{ &table, &indexes };
+    
+    if (!sameDepartmentStats(runComplexOperationsSalaryIndex(input), runComplexOperationsSoA(table))) {
+        cout << "Salary index complex chain does not match the scan\n";
+    }
+    auto scan = runProjectionScan(input);
+    if (!sameHireDates(table, runProjectionAgeIndex(input), scan)) {
+        cout << "Age index projection does not match the scan\n";
+    }
+    if (!sameHireDates(table, runProjectionHireDateIndex(input), scan)) {
+        cout << "Hire date index projection does not match the scan\n";
+    }
+    
+    auto complexScan = measure(table, runComplexOperationsSoA);
+    auto complexSalary = measure(input, runComplexOperationsSalaryIndex);
+    printTiming("Complex LINQ Chain [scan]", complexScan);
+    printTiming("Complex LINQ Chain [salary index]", complexSalary, &complexScan);
+    printBreakEven(salaryBuild, complexScan, complexSalary);
+    
+    auto projectionScan = measure(input, runProjectionScan);
+    auto projectionAge = measure(input, runProjectionAgeIndex);
+    auto projectionHireDate = measure(input, runProjectionHireDateIndex);
+    printTiming("Projection with Where [scan]", projectionScan);
+    printTiming("Projection with Where [age index]", projectionAge, &projectionScan);
+    printBreakEven(ageBuild, projectionScan, projectionAge);
+    printTiming("Projection with Where [hireDate index]", projectionHireDate, &projectionScan);
+    printBreakEven(hireDateBuild, projectionScan, projectionHireDate);
+}
+
+// Runs every parallel kernel at 1, 2, 4, ... up to maxThreads threads, so the
+// scaling curve of each test is printed in one block
+void measureScaling(const vector<Person>& people, unsigned maxThreads, bool workStealing) {
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+    
+    vector<unique_ptr<ThreadPool>> pools;
+    for (auto t : threadCounts) pools.push_back(make_unique<ThreadPool>(t));
+    
+    g_results.section = "Parallel Scaling";
+    cout << "\nParallel Scaling (hardware threads: " << thread::hardware_concurrency()
+         << ", scheduler: " << (workStealing ? "work-stealing" : "static") << "):\n========================\n";
+    
+    auto scale = [&](const string& label, auto op) {
+        Timing single{};
+        for (size_t i = 0; i < pools.size(); ++i) {
+            auto t = measure(ParallelInput{ &people, pools[i].get() }, op);
+            if (i == 0) single = t;
+            printTiming(label + " [" + to_string(threadCounts[i]) + "T]", t, i == 0 ? nullptr : &single);
+        }
+    };
+    
+    // Only the kernels with uneven group or sort work have a work-stealing version
+    if (workStealing) {
+        scale("Complex LINQ Chain", runComplexOperationsStealing);
+        scale("GroupBy with Aggregation", runGroupByStealing);
+        scale("String Operations", runStringOpsStealing);
+    } else {
+        scale("Complex LINQ Chain", runComplexOperationsParallel);
+        scale("GroupBy with Aggregation", runGroupByParallel);
+        scale("String Operations", runStringOpsParallel);
+    }
+    scale("Nested Queries", runNestedParallel);
+    scale("Projection with Where", runProjectionParallel);
+}
+
+// Shared scan: the five tests as one dashboard over one snapshot. The table
+// is walked in blocks small enough to stay in L2, and every selected query
+// consumes a block before the next one is loaded, so the columns are read
+// from memory once instead of once per query. The same function with a
+// single query selected is the separate scan it is compared against.
+
+constexpr unsigned kScanComplex = 1u << 0;
+constexpr unsigned kScanGroupBy = 1u << 1;
+constexpr unsigned kScanStrings = 1u << 2;
+constexpr unsigned kScanNested = 1u << 3;
+constexpr unsigned kScanProjection = 1u << 4;
+constexpr unsigned kScanAll = kScanComplex | kScanGroupBy | kScanStrings | kScanNested | kScanProjection;
+
+// age, salary, hireDate and department of 8K rows: 168KB
+constexpr size_t kSharedScanBlock = 8 * 1024;
+
+struct SharedScanInput {
+    const PersonTable* table;
+    unsigned queries;
+};
+
+// Results of the queries a shared scan ran; the others stay empty
+struct SharedScanResults {
+    vector<DepartmentStats> complex;
+    vector<AgeGroupStats> groupBy;
+    vector<PersonProjection> strings;
+    vector<DepartmentAnalysis> nested;
+    vector<YoungProfessional> projection;
+};
+
+SharedScanResults runSharedScan(const SharedScanInput& in) {
+    const auto& table = *in.table;
+    const unsigned queries = in.queries;
+    auto now = Clock::now();
+    auto cutoff = (now - Days(static_cast<int>(365.25 * 5))).time_since_epoch().count();
+    
+    array<SalaryStats, kDepartmentCount> complex{};
+    FlatGroups<DeptAgeDomain, TenureStats> groups;
+    array<Headcount, kDepartmentCount> nested{};
+    vector<PersonProjection> projections;
+    
+    auto byHireDate = [&](uint32_t a, uint32_t b) { return table.hireDate[a] < table.hireDate[b]; };
+    TopK<uint32_t, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    
+    Selection selected(min(kSharedScanBlock, table.size()));
+    PersonTable block;
+    block.nameHeap = table.nameHeap;
+    
+    for (size_t begin = 0; begin < table.size(); begin += kSharedScanBlock) {
+        const size_t end = min(table.size(), begin + kSharedScanBlock);
+        setSliceColumns(block, table, begin, end);
+        const auto base = static_cast<uint32_t>(begin);
+        
+        if (queries & kScanComplex) {
+            selected.size = g_filters.complex(block, selected.rows.get());
+            for (uint32_t row : selected) {
+                auto& acc = complex[block.department[row]];
+                acc.count++;
+                acc.totalSalary += block.salary[row];
+                acc.maxSalary = max(acc.maxSalary, block.salary[row]);
+                acc.minAge = min(acc.minAge, block.age[row]);
+            }
+        }
+        
+        if (queries & kScanProjection) {
+            selected.size = g_filters.projection(block, cutoff, selected.rows.get());
+            for (uint32_t row : selected) top.push(base + row);
+        }
+        
+        if (queries & kScanGroupBy) {
+            for (size_t i = 0; i < block.size(); ++i) {
+                auto& acc = groups(block.department[i], block.age[i] / 10 - kFirstAgeGroup / 10);
+                acc.count++;
+                acc.totalSalary += block.salary[i];
+                acc.totalTenure += static_cast<double>(duration_cast<Days>(now - block.hireDate[i]).count());
+            }
+        }
+        
+        if (queries & kScanNested) {
+            for (size_t i = 0; i < block.size(); ++i) {
+                auto& acc = nested[block.department[i]];
+                acc.employees++;
+                if (block.salary[i] > 75000) acc.highEarners++;
+                acc.totalAge += block.age[i];
+            }
+        }
+        
+        if (queries & kScanStrings) g_strings.collectProjections(block, projections);
+    }
+    
+    SharedScanResults results;
+    if (queries & kScanComplex) results.complex = departmentStats(complex);
+    if (queries & kScanGroupBy) results.groupBy = ageGroupStats(groups);
+    if (queries & kScanNested) results.nested = departmentAnalysis(nested);
+    if (queries & kScanStrings) {
+        sortProjections(projections);
+        results.strings = move(projections);
+    }
+    if (queries & kScanProjection) {
+        for (auto row : top.take()) results.projection.push_back(youngProfessional(table, row, now));
+    }
+    return results;
+}
+
+// Times the five queries as five separate scans and as one shared scan,
+// next to the five regular columnar kernels run back to back. The sort of
+// the String Operations result dwarfs the scans and no sharing helps it, so
+// the four aggregations are also timed without it.
+void measureSharedScan(const PersonTable& table) {
+    g_results.section = "Shared Scan";
+    cout << "\nShared Scan (blocks of " << kSharedScanBlock << " rows):\n========================\n";
+    
+    auto kernels = measure(table, [](const PersonTable& t) {
+        return make_tuple(runComplexOperationsSoA(t), runGroupByFlatSoA(t), runStringOpsSoA(t),
+            runNestedSinglePassSoA(t), runProjectionSoA(t));
+    });
+    printTiming("Five queries [SoA kernels]", kernels);
+    
+    auto compare = [&](const string& label, unsigned queries) {
+        auto separate = measure(SharedScanInput{ &table, queries }, [](const SharedScanInput& in) {
+            vector<SharedScanResults> results;
+            for (unsigned query = 1; query <= in.queries; query <<= 1) {
+                if (in.queries & query) results.push_back(runSharedScan(SharedScanInput{ in.table, query }));
+            }
+            return results;
+        });
+        auto shared = measure(SharedScanInput{ &table, queries }, runSharedScan);
+        printTiming(label + " [separate scans]", separate);
+        printTiming(label + " [shared scan]", shared, &separate);
+    };
+    
+    compare("Five queries", kScanAll);
+    compare("Four aggregations", kScanAll & ~kScanStrings);
+}
+
+// Compressed columns. age, salary, hireDay and department span far fewer
+// values than the 1 to 8 bytes each is stored in, so the packed table keeps
+// each of them frame-of-reference encoded: the value minus the column minimum,
+// in just enough bits for the range, packed back to back. The kernels below
+// filter and unpack one block of codes at a time in registers and L1,
+// compare codes against thresholds moved into code space and sum codes,
+// adding the base back once per group.
+
+// One frame-of-reference bit-packed integer column. Field i occupies bits
+// [i * bits, (i + 1) * bits) of the byte buffer, which ends with 8 bytes of
+// padding so every field can be read with one unaligned 8-byte load. Blocks
+// starting at a multiple of 8 rows go through the g_filters packed kernels.
+class PackedColumn {
+public:
+    static constexpr unsigned kMaxBits = 25;
+    
+    PackedColumn() = default;
+    
+    template <typename T, typename Value>
+    PackedColumn(const Column<T>& column, Value value) {
+        if (column.size() == 0) return;
+        int64_t low = value(column[0]), high = low;
+        for (const auto& x : column) {
+            low = min(low, value(x));
+            high = max(high, value(x));
+        }
+        auto range = static_cast<uint64_t>(high - low);
+        while (bits < kMaxBits && (range >> bits) != 0) bits++;
+        if ((range >> bits) != 0) throw runtime_error("column range does not fit in " + to_string(kMaxBits) + " bits");
+        
+        base = low;
+        bytes.assign((column.size() * bits + 7) / 8 + 8, 0);
+        for (size_t i = 0; i < column.size(); ++i) {
+            auto code = static_cast<uint64_t>(value(column[i]) - low);
+            size_t bit = i * bits;
+            uint64_t word;
+            memcpy(&word, bytes.data() + bit / 8, sizeof(word));
+            word |= code << (bit % 8);
+            memcpy(bytes.data() + bit / 8, &word, sizeof(word));
+        }
+    }
+    
+    uint32_t code(size_t i) const { return packedCode(bytes.data(), bits, i); }
+    
+    // Codes of rows [begin, begin + count) into out; begin is a multiple of 8
+    void unpack(size_t begin, size_t count, uint32_t* out) const {
+        g_filters.unpack(bytes.data() + begin / 8 * bits, bits, count, out);
+    }
+    
+    // The codes in [low, high) of the block starting at row begin, a multiple of 8
+    PackedRange range(size_t begin, uint32_t low, uint32_t high) const {
+        return PackedRange{ bytes.data() + begin / 8 * bits, bits, low, high };
+    }
+    
+    int64_t operator[](size_t i) const { return base + code(i); }
+    
+    // Code-space thresholds: value i > t exactly when code(i) >= firstAbove(t),
+    // and value i < t exactly when code(i) < firstAtLeast(t)
+    uint32_t firstAbove(int64_t threshold) const { return firstAtLeast(threshold + 1); }
+    uint32_t firstAtLeast(int64_t threshold) const {
+        return static_cast<uint32_t>(clamp<int64_t>(threshold - base, 0, endCode()));
+    }
+    
+    // One past the largest code
+    uint32_t endCode() const { return uint32_t(1) << bits; }
+    
+    size_t byteCount() const { return bytes.size(); }
+    
+    int64_t base = 0;
+    unsigned bits = 0;
+    
+private:
+    vector<uint8_t> bytes;
+};
+
+// The packed table. Salaries are doubles, which do not fit in 17 bits
+// losslessly, so the packed salary column holds ceil(salary): every salary
+// predicate in the tests is salary > integer, and salary > t exactly when
+// ceil(salary) > t. Sums and maxima still need the exact values, so those
+// kernels read the plain salary column, but only for the rows that pass the
+// packed filters. Results are materialized from the plain table.
+struct PackedTable {
+    const PersonTable* table;
+    PackedColumn age;
+    PackedColumn salaryCeil;
+    PackedColumn hireDay;
+    PackedColumn department;
+    
+    size_t size() const { return table->size(); }
+    
+    size_t byteCount() const {
+        return age.byteCount() + salaryCeil.byteCount() + hireDay.byteCount() + department.byteCount();
+    }
+};
+
+PackedTable packTable(const PersonTable& table) {
+    return PackedTable{ &table,
+        PackedColumn(table.age, [](int age) { return static_cast<int64_t>(age); }),
+        PackedColumn(table.salary, [](double salary) { return static_cast<int64_t>(ceil(salary)); }),
+        PackedColumn(table.hireDay, [](int32_t day) { return static_cast<int64_t>(day); }),
+        PackedColumn(table.department, [](uint8_t code) { return static_cast<int64_t>(code); }) };
+}
+
+// Rows per unpacked block: the codes of a few columns stay in L1
+constexpr size_t kPackedBlock = 1024;
+
+// Calls fn(begin, count) for consecutive blocks of the table's rows
+template <typename F>
+void forEachPackedBlock(const PackedTable& packed, F&& fn) {
+    for (size_t begin = 0; begin < packed.size(); begin += kPackedBlock) {
+        fn(begin, min(kPackedBlock, packed.size() - begin));
+    }
+}
+
+// The Complex chain as one filter-and-fold pass over the plain columns, the
+// same work as the packed kernel without runComplexOperationsSoA's in-group sort
+vector<DepartmentStats> runComplexOperationsFoldSoA(const PersonTable& table) {
+    Selection filtered(table.size());
+    filtered.size = g_filters.complex(table, filtered.rows.get());
+    
+    array<SalaryStats, kDepartmentCount> total{};
+    for (uint32_t row : filtered) {
+        auto& acc = total[table.department[row]];
+        acc.count++;
+        acc.totalSalary += table.salary[row];
+        acc.maxSalary = max(acc.maxSalary, table.salary[row]);
+        acc.minAge = min(acc.minAge, table.age[row]);
+    }
+    return departmentStats(total);
+}
+
+// Complex chain: the packed filter, count and minimum age in code space, and
+// the exact salary sum and maximum for the selected rows only
+vector<DepartmentStats> runComplexOperationsPacked(const PackedTable& packed) {
+    const auto& salary = packed.table->salary;
+    const auto minAge = packed.age.firstAbove(25);
+    const auto minSalary = packed.salaryCeil.firstAbove(50000);
+    
+    struct Accumulator {
+        size_t count = 0;
+        double totalSalary = 0;
+        double maxSalary = 0;
+        uint32_t minAgeCode = numeric_limits<uint32_t>::max();
+    };
+    array<Accumulator, kDepartmentCount> groups{};
+    
+    uint32_t age[kPackedBlock], department[kPackedBlock], selected[kPackedBlock];
+    forEachPackedBlock(packed, [&](size_t begin, size_t count) {
+        PackedRange ranges[] = { packed.age.range(begin, minAge, packed.age.endCode()),
+            packed.salaryCeil.range(begin, minSalary, packed.salaryCeil.endCode()) };
+        size_t hits = g_filters.selectPacked(ranges, 2, count, selected);
+        
+        packed.age.unpack(begin, count, age);
+        packed.department.unpack(begin, count, department);
+        for (size_t k = 0; k < hits; ++k) {
+            auto j = selected[k];
+            auto& acc = groups[department[j]];
+            acc.count++;
+            acc.totalSalary += salary[begin + j];
+            acc.maxSalary = max(acc.maxSalary, salary[begin + j]);
+            acc.minAgeCode = min(acc.minAgeCode, age[j]);
+        }
+    });
+    
+    // groups is indexed by department code minus the column base
+    array<SalaryStats, kDepartmentCount> total{};
+    for (size_t code = static_cast<size_t>(packed.department.base); code < kDepartmentCount; ++code) {
+        const auto& acc = groups[code - static_cast<size_t>(packed.department.base)];
+        if (acc.count == 0) continue;
+        total[code] = SalaryStats{ acc.count, acc.totalSalary, acc.maxSalary, static_cast<int>(packed.age.base + acc.minAgeCode) };
+    }
+    return departmentStats(total);
+}
+
+// GroupBy summing hire day codes; a group's hire day total is its code total
+// plus count * base, and its tenure total follows as in HireDayStats
+vector<AgeGroupStats> runGroupByPacked(const PackedTable& packed) {
+    const auto& salary = packed.table->salary;
+    FlatGroups<DeptAgeDomain, HireDayStats> groups;
+    
+    // Age code to age group index, so the loop never decodes an age
+    vector<uint8_t> ageGroup(size_t(1) << packed.age.bits);
+    for (size_t code = 0; code < ageGroup.size(); ++code) {
+        ageGroup[code] = static_cast<uint8_t>(clamp<int64_t>((packed.age.base + static_cast<int64_t>(code)) / 10 - kFirstAgeGroup / 10, 0, kAgeGroupCount - 1));
+    }
+    
+    auto today = epochDay(Clock::now());
+    
+    uint32_t age[kPackedBlock], hireDay[kPackedBlock], department[kPackedBlock];
+    forEachPackedBlock(packed, [&](size_t begin, size_t count) {
+        packed.age.unpack(begin, count, age);
+        packed.hireDay.unpack(begin, count, hireDay);
+        packed.department.unpack(begin, count, department);
+        
+        for (size_t j = 0; j < count; ++j) {
+            auto& acc = groups(static_cast<size_t>(packed.department.base) + department[j], ageGroup[age[j]]);
+            acc.count++;
+            acc.totalSalary += salary[begin + j];
+            acc.totalHireDay += hireDay[j];
+        }
+    });
+    
+    vector<AgeGroupStats> result;
+    for (size_t slot = 0; slot < groups.slots.size(); ++slot) {
+        auto acc = groups.slots[slot];
+        if (acc.count <= 5) continue;
+        acc.totalHireDay += static_cast<int64_t>(acc.count) * packed.hireDay.base;
+        result.push_back(ageGroupStats(slot, acc.count, acc.totalSalary, acc.totalTenure(today)));
+    }
+    return result;
+}
+
+// Nested Queries in one pass entirely over packed fields
+vector<DepartmentAnalysis> runNestedPacked(const PackedTable& packed) {
+    const auto minSalary = packed.salaryCeil.firstAbove(75000);
+    
+    struct Accumulator {
+        size_t employees = 0;
+        size_t highEarners = 0;
+        uint64_t totalAgeCode = 0;
+    };
+    array<Accumulator, kDepartmentCount> groups{};
+    
+    uint32_t age[kPackedBlock], salaryCeil[kPackedBlock], department[kPackedBlock];
+    forEachPackedBlock(packed, [&](size_t begin, size_t count) {
+        packed.age.unpack(begin, count, age);
+        packed.salaryCeil.unpack(begin, count, salaryCeil);
+        packed.department.unpack(begin, count, department);
+        
+        for (size_t j = 0; j < count; ++j) {
+            auto& acc = groups[department[j]];
+            acc.employees++;
+            acc.highEarners += salaryCeil[j] >= minSalary;
+            acc.totalAgeCode += age[j];
+        }
+    });
+    
+    array<Headcount, kDepartmentCount> total{};
+    for (size_t code = static_cast<size_t>(packed.department.base); code < kDepartmentCount; ++code) {
+        const auto& acc = groups[code - static_cast<size_t>(packed.department.base)];
+        auto totalAge = static_cast<int64_t>(acc.totalAgeCode) + static_cast<int64_t>(acc.employees) * packed.age.base;
+        total[code] = Headcount{ acc.employees, acc.highEarners, totalAge };
+    }
+    return departmentAnalysis(total);
+}
+
+// Projection at day resolution: all three predicates and the top-N order run
+// on codes, and only the kProjectionLimit result rows touch the plain table
+vector<YoungProfessional> runProjectionPacked(const PackedTable& packed) {
+    auto now = Clock::now();
+    auto today = epochDay(now);
+    auto cutoffDay = epochDay(now - Days(static_cast<int>(365.25 * 5)));
+    
+    const auto minDay = packed.hireDay.firstAbove(cutoffDay);
+    const auto ageLimit = packed.age.firstAtLeast(30);
+    const auto minSalary = packed.salaryCeil.firstAbove(60000);
+    
+    // Candidates are (hire day code, row) pairs, so the heap compares integers
+    TopK<uint64_t, less<uint64_t>> top(kProjectionLimit, less<uint64_t>());
+    
+    uint32_t selected[kPackedBlock];
+    forEachPackedBlock(packed, [&](size_t begin, size_t count) {
+        PackedRange ranges[] = { packed.hireDay.range(begin, minDay, packed.hireDay.endCode()),
+            packed.age.range(begin, 0, ageLimit), packed.salaryCeil.range(begin, minSalary, packed.salaryCeil.endCode()) };
+        size_t hits = g_filters.selectPacked(ranges, 3, count, selected);
+        for (size_t k = 0; k < hits; ++k) {
+            auto row = begin + selected[k];
+            top.push(uint64_t(packed.hireDay.code(row)) << 32 | row);
+        }
+    });
+    
+    vector<YoungProfessional> result;
+    for (auto candidate : top.take()) result.push_back(youngProfessionalByDay(*packed.table, static_cast<uint32_t>(candidate), today));
+    return result;
+}
+
+// Times the packed kernels against the plain columnar kernels doing the same work
+void measurePacked(const PersonTable& table) {
+    // A --data file can hold a column whose range does not fit in kMaxBits
+    PackedTable packed{};
+    try {
+        packed = packTable(table);
+    } catch (const runtime_error& e) {
+        cout << "\nPacked Columns: skipped, " << e.what() << "\n";
+        return;
+    }
+    
+    g_results.section = "Packed Columns";
+    cout << "\nPacked Columns (age " << packed.age.bits << ", salary " << packed.salaryCeil.bits << ", hireDay "
+         << packed.hireDay.bits << ", department " << packed.department.bits << " bits per row):\n========================\n";
+    
+    const size_t plainBytes = table.age.size() * sizeof(int) + table.salary.size() * sizeof(double)
+        + table.hireDay.size() * sizeof(int32_t) + table.department.size();
+    cout << setw(kLabelWidth) << left << "Column bytes [plain -> packed]" << ": " << fixed << setprecision(1)
+         << static_cast<double>(plainBytes) / 1e6 << "MB -> " << static_cast<double>(packed.byteCount()) / 1e6 << "MB ("
+         << static_cast<double>(plainBytes) / static_cast<double>(packed.byteCount()) << "x smaller)\n";
+    
+    if (!sameDepartmentStats(runComplexOperationsPacked(packed), runComplexOperationsFoldSoA(table)) ||
+        !sameAgeGroupStats(runGroupByPacked(packed), runGroupByFlatDaysSoA(table), Tenure::Days) ||
+        !sameDepartmentAnalysis(runNestedPacked(packed), runNestedSinglePassSoA(table)) ||
+        !sameYoungProfessionals(runProjectionPacked(packed), runProjectionDaysSoA(table), Tenure::Days)) {
+        cout << "Packed kernels do not match the columnar kernels\n";
+    }
+    
+    auto compare = [&](const string& label, auto plainKernel, auto packedKernel) {
+        auto plain = measure(table, plainKernel);
+        auto compressed = measure(packed, packedKernel);
+        printTiming(label + " [SoA]", plain);
+        printTiming(label + " [packed]", compressed, &plain);
+    };
+    
+    compare("Complex LINQ Chain", runComplexOperationsFoldSoA, runComplexOperationsPacked);
+    compare("GroupBy with Aggregation", runGroupByFlatDaysSoA, runGroupByPacked);
+    compare("Nested Queries", runNestedSinglePassSoA, runNestedPacked);
+    compare("Projection with Where", runProjectionDaysSoA, runProjectionPacked);
+}
+
+// High-cardinality grouping. The five tests group by at most 25 keys, so
+// they index dense arrays; real data groups by keys such as cost center with
+// tens of thousands of values or more. This section runs the Complex chain
+// (filter, group, count > 10, sort by average salary) grouped by a cost
+// center column with --groups distinct values instead of by department.
+
+// Cost center of every row. The ids are scattered over the 32-bit range like
+// real codes, so no kernel can index them directly, and they come from their
+// own random stream, so the Person rows are the same for any --groups value.
+vector<uint32_t> generateCostCenters(size_t rows, size_t groups, double skew) {
+    mt19937 rng{ 43 };
+    vector<uint32_t> costCenter(rows);
+    auto id = [](uint32_t index) { return index * 2654435761u; };
+    
+    if (skew > 0) {
+        vector<double> weights;
+        for (size_t rank = 1; rank <= groups; ++rank) weights.push_back(1.0 / pow(static_cast<double>(rank), skew));
+        discrete_distribution<uint32_t> pick(weights.begin(), weights.end());
+        for (auto& c : costCenter) c = id(pick(rng));
+    } else {
+        uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(groups - 1));
+        for (auto& c : costCenter) c = id(pick(rng));
+    }
+    return costCenter;
+}
+
+string costCenterName(uint32_t key) { return "CC" + to_string(key); }
+
+uint64_t hashKey(uint32_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 29);
+}
+
+// Open-addressing aggregation table: one flat array of slots holding the key,
+// its hash and the accumulator in place, with no per-group allocation. Linear
+// probing over a power-of-two capacity kept at most half full. The stored hash
+// rejects most mismatching slots with one compare and makes growing a copy
+// without rehashing. Bit 63 of a stored hash marks the slot as used.
+template <typename Acc>
+class HashAggregator {
+public:
+    explicit HashAggregator(size_t expectedGroups = 0) {
+        size_t capacity = 16;
+        while (capacity < 2 * expectedGroups) capacity *= 2;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+    
+    // The accumulator of key, value-initialized on first use; hash is hashKey(key)
+    Acc& find(uint32_t key, uint64_t hash) {
+        const uint64_t tag = hash | kUsed;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            auto& slot = slots[i];
+            if (slot.tag == tag && slot.key == key) return slot.acc;
+            if (slot.tag == 0) {
+                if (2 * (count + 1) > slots.size()) {
+                    grow();
+                    return find(key, hash);
+                }
+                slot.tag = tag;
+                slot.key = key;
+                count++;
+                return slot.acc;
+            }
+        }
+    }
+    
+    Acc& operator[](uint32_t key) { return find(key, hashKey(key)); }
+    
+    size_t size() const { return count; }
+    
+    // Calls fn(key, acc) for every group, in slot order
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (const auto& slot : slots) {
+            if (slot.tag != 0) fn(slot.key, slot.acc);
+        }
+    }
+    
+private:
+    static constexpr uint64_t kUsed = uint64_t(1) << 63;
+    
+    struct Slot {
+        uint64_t tag = 0;
+        uint32_t key = 0;
+        Acc acc{};
+    };
+    
+    void grow() {
+        vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for (const auto& slot : old) {
+            if (slot.tag == 0) continue;
+            size_t i = slot.tag & mask;
+            while (slots[i].tag != 0) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+    
+    vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+};
+
+struct CostCenterInput {
+    const PersonTable* table;
+    const vector<uint32_t>* costCenter;
+    ThreadPool* pool;
+};
+
+// Steps 3-5 of the chain over one set of cost center groups
+template <typename Groups>
+void appendCostCenterStats(const Groups& groups, vector<DepartmentStats>& stats) {
+    groups.forEach([&](uint32_t key, const SalaryStats& acc) {
+        if (acc.count <= 10) return;
+        stats.push_back(DepartmentStats{ costCenterName(key), acc.count, acc.totalSalary / static_cast<double>(acc.count), acc.maxSalary, acc.minAge });
+    });
+}
+
+void addToSalaryStats(SalaryStats& acc, const PersonTable& table, uint32_t row) {
+    acc.count++;
+    acc.totalSalary += table.salary[row];
+    acc.maxSalary = max(acc.maxSalary, table.salary[row]);
+    acc.minAge = min(acc.minAge, table.age[row]);
+}
+
+// What the row kernels do with departments, applied to cost centers: a
+// node-based hash map from key to the list of its rows
+vector<DepartmentStats> runCostCenterNodeMap(const CostCenterInput& in) {
+    const auto& table = *in.table;
+    const auto& costCenter = *in.costCenter;
+    
+    Selection filtered(table.size());
+    filtered.size = g_filters.complex(table, filtered.rows.get());
+    
+    unordered_map<uint32_t, vector<uint32_t>> groups;
+    for (uint32_t row : filtered) groups[costCenter[row]].push_back(row);
+    
+    vector<DepartmentStats> stats;
+    for (const auto& [key, rows] : groups) {
+        if (rows.size() <= 10) continue;
+        SalaryStats acc;
+        for (auto row : rows) addToSalaryStats(acc, table, row);
+        stats.push_back(DepartmentStats{ costCenterName(key), acc.count, acc.totalSalary / static_cast<double>(acc.count), acc.maxSalary, acc.minAge });
+    }
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<DepartmentStats> runCostCenterHash(const CostCenterInput& in) {
+    const auto& table = *in.table;
+    const auto& costCenter = *in.costCenter;
+    
+    Selection filtered(table.size());
+    filtered.size = g_filters.complex(table, filtered.rows.get());
+    
+    HashAggregator<SalaryStats> groups;
+    for (uint32_t row : filtered) addToSalaryStats(groups[costCenter[row]], table, row);
+    
+    vector<DepartmentStats> stats;
+    appendCostCenterStats(groups, stats);
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+// Radix partitions of the parallel version: enough that each partition's
+// table fits in L2 up to a few million groups
+constexpr size_t kHashRadixBits = 6;
+constexpr size_t kHashPartitions = size_t(1) << kHashRadixBits;
+
+// Radix-partitioned parallel aggregation. Every worker filters its slice of
+// the rows and scatters (hash, row) into one buffer per partition, chosen by
+// hash bits the tables do not index with. Every partition then holds whole
+// groups, so one worker aggregates it into its own small table and the
+// partial results only need concatenating, never merging.
+vector<DepartmentStats> runCostCenterPartitioned(const CostCenterInput& in) {
+    const auto& table = *in.table;
+    const auto& costCenter = *in.costCenter;
+    auto& pool = *in.pool;
+    
+    struct HashedRow {
+        uint64_t hash;
+        uint32_t row;
+    };
+    auto partitionOf = [](uint64_t hash) { return static_cast<size_t>(hash >> 40) & (kHashPartitions - 1); };
+    
+    vector<vector<vector<HashedRow>>> scattered(pool.size(), vector<vector<HashedRow>>(kHashPartitions));
+    pool.parallelFor(table.size(), [&](unsigned part, size_t begin, size_t end) {
+        PersonTable slice;
+        setSliceColumns(slice, table, begin, end);
+        Selection filtered(slice.size());
+        filtered.size = g_filters.complex(slice, filtered.rows.get());
+        
+        auto& buffers = scattered[part];
+        for (auto& buffer : buffers) buffer.reserve(filtered.size / kHashPartitions * 5 / 4);
+        for (uint32_t r : filtered) {
+            auto row = static_cast<uint32_t>(begin + r);
+            auto hash = hashKey(costCenter[row]);
+            buffers[partitionOf(hash)].push_back(HashedRow{ hash, row });
+        }
+    });
+    
+    vector<vector<DepartmentStats>> partial(kHashPartitions);
+    pool.parallelFor(kHashPartitions, [&](unsigned, size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            HashAggregator<SalaryStats> groups;
+            for (const auto& buffers : scattered) {
+                for (const auto& item : buffers[p]) addToSalaryStats(groups.find(costCenter[item.row], item.hash), table, item.row);
+            }
+            appendCostCenterStats(groups, partial[p]);
+        }
+    });
+    
+    vector<DepartmentStats> stats;
+    for (auto& part : partial) stats.insert(stats.end(), make_move_iterator(part.begin()), make_move_iterator(part.end()));
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+// Times the Complex chain grouped by cost center through the node-based map,
+// the open-addressing table and its radix-partitioned parallel version
+void measureCostCenters(const PersonTable& table, size_t groups, double skew, unsigned threads) {
+    auto costCenter = generateCostCenters(table.size(), groups, skew);
+    ThreadPool pool(threads);
+    CostCenterInput input{ &table, &costCenter, &pool };
+    
+    g_results.section = "Hash Aggregation";
+    cout << "\nHash Aggregation (Complex LINQ Chain by " << groups << " cost centers):\n========================\n";
+    
+    auto expected = runCostCenterNodeMap(input);
+    if (!sameDepartmentStats(runCostCenterHash(input), expected)) {
+        cout << "Open-addressing aggregation does not match the node map\n";
+    }
+    if (!sameDepartmentStats(runCostCenterPartitioned(input), expected)) {
+        cout << "Radix-partitioned aggregation does not match the node map\n";
+    }
+    
+    auto nodeMap = measure(input, runCostCenterNodeMap);
+    auto hash = measure(input, runCostCenterHash);
+    auto partitioned = measure(input, runCostCenterPartitioned);
+    printTiming("Cost centers [node map + row lists]", nodeMap);
+    printTiming("Cost centers [open addressing]", hash, &nodeMap);
+    printTiming("Cost centers [radix partitioned, " + to_string(pool.size()) + "T]", partitioned, &nodeMap);
+}
+
+// NUMA placement. Every worker owns one contiguous partition of the table,
+// runs on the CPUs of one node and builds its partition itself, so first
+// touch puts those columns in that node's memory. The kernels fold each
+// partition into accumulators local to its worker, so the only cross-node
+// traffic is the final merge of a few small partial results.
+
+struct NumaNode {
+    int id;
+    vector<int> cpus;
+};
+
+// A CPU list in the kernel's format, e.g. "0-3,8-11"
+vector<int> parseCpuList(const string& text) {
+    vector<int> cpus;
+    stringstream in(text);
+    string range;
+    while (getline(in, range, ',')) {
+        if (range.empty() || !isdigit(static_cast<unsigned char>(range[0]))) continue;
+        auto dash = range.find('-');
+        int first = stoi(range.substr(0, dash));
+        int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+constexpr int kMaxNumaNodes = 64;
+
+// Nodes with CPUs this process may run on. Falls back to one node holding
+// every CPU where the platform reports no topology.
+vector<NumaNode> detectNumaNodes() {
+    vector<NumaNode> nodes;
+#if defined(_WIN32)
+    ULONG highest = 0;
+    if (GetNumaHighestNodeNumber(&highest)) {
+        for (ULONG node = 0; node <= highest && node < kMaxNumaNodes; ++node) {
+            // Processor group 0 only, like AffinityScope
+            ULONGLONG mask = 0;
+            if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask)) continue;
+            NumaNode n{ static_cast<int>(node), {} };
+            for (int cpu = 0; cpu < 64; ++cpu) {
+                if ((mask >> cpu) & 1) n.cpus.push_back(cpu);
+            }
+            if (!n.cpus.empty()) nodes.push_back(move(n));
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool restricted = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int node = 0; node < kMaxNumaNodes; ++node) {
+        ifstream in("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+        if (!in) continue;
+        string text;
+        getline(in, text);
+        
+        NumaNode n{ node, {} };
+        for (int cpu : parseCpuList(text)) {
+            if (!restricted || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) n.cpus.push_back(cpu);
+        }
+        if (!n.cpus.empty()) nodes.push_back(move(n));
+    }
+#endif
+    if (nodes.empty()) {
+        NumaNode all{ 0, {} };
+        for (unsigned cpu = 0; cpu < max(1u, thread::hardware_concurrency()); ++cpu) all.cpus.push_back(static_cast<int>(cpu));
+        nodes.push_back(move(all));
+    }
+    return nodes;
+}
+
+// A pool with worker w pinned to the CPUs of nodes[workerNode[w]], and the
+// partition of every worker built by that worker
+struct NumaPlacement {
+    vector<NumaNode> nodes;
+    vector<size_t> workerNode;
+    unique_ptr<ThreadPool> pool;
+    vector<PersonTable> partitions;
+    
+    // Workers are spread over the nodes in proportion to their CPU counts.
+    // Worker 0 is the calling thread, which must stay on its node's CPUs for
+    // as long as the placement is used; pinCaller() gives the scope for that.
+    NumaPlacement(const vector<Person>& people, unsigned workers) : nodes(detectNumaNodes()) {
+        vector<size_t> cpuNode;
+        for (size_t n = 0; n < nodes.size(); ++n) cpuNode.insert(cpuNode.end(), nodes[n].cpus.size(), n);
+        
+        vector<vector<int>> affinity;
+        for (unsigned w = 0; w < workers; ++w) {
+            workerNode.push_back(cpuNode[static_cast<size_t>(w) * cpuNode.size() / workers]);
+            affinity.push_back(nodes[workerNode.back()].cpus);
+        }
+        pool = make_unique<ThreadPool>(workers, move(affinity));
+        
+        AffinityScope pin = pinCaller();
+        partitions.resize(pool->size());
+        pool->run([&](unsigned worker) {
+            size_t begin = people.size() * worker / pool->size();
+            size_t end = people.size() * (worker + 1) / pool->size();
+            partitions[worker] = toColumnar(people, begin, end);
+        });
+    }
+    
+    AffinityScope pinCaller() const { return AffinityScope(nodes[workerNode[0]].cpus); }
+    
+    // The workers running on node n
+    vector<unsigned> workersOn(size_t n) const {
+        vector<unsigned> workers;
+        for (unsigned w = 0; w < workerNode.size(); ++w) {
+            if (workerNode[w] == n) workers.push_back(w);
+        }
+        return workers;
+    }
+};
+
+struct NumaInput {
+    const vector<PersonTable>* partitions; // partition w belongs to worker w
+    ThreadPool* pool;
+};
+
+// The same partitions as views of one table, whose pages sit wherever the
+// thread that filled it ran
+vector<PersonTable> slicePartitions(const PersonTable& table, size_t parts) {
+    vector<PersonTable> partitions;
+    for (size_t part = 0; part < parts; ++part) {
+        partitions.push_back(sliceTable(table, table.size() * part / parts, table.size() * (part + 1) / parts));
+    }
+    return partitions;
+}
+
+vector<DepartmentStats> runComplexOperationsNuma(const NumaInput& in) {
+    const auto& partitions = *in.partitions;
+    vector<array<SalaryStats, kDepartmentCount>> partials(partitions.size());
+    
+    in.pool->run([&](unsigned worker) {
+        const auto& table = partitions[worker];
+        Selection filtered(table.size());
+        filtered.size = g_filters.complex(table, filtered.rows.get());
+        
+        array<SalaryStats, kDepartmentCount> local{};
+        for (uint32_t row : filtered) {
+            auto& acc = local[table.department[row]];
+            acc.count++;
+            acc.totalSalary += table.salary[row];
+            acc.maxSalary = max(acc.maxSalary, table.salary[row]);
+            acc.minAge = min(acc.minAge, table.age[row]);
+        }
+        partials[worker] = local;
+    });
+    
+    array<SalaryStats, kDepartmentCount> total{};
+    for (const auto& partial : partials) {
+        for (size_t code = 0; code < kDepartmentCount; ++code) total[code].merge(partial[code]);
+    }
+    return departmentStats(total);
+}
+
+vector<AgeGroupStats> runGroupByNuma(const NumaInput& in) {
+    const auto& partitions = *in.partitions;
+    vector<FlatGroups<DeptAgeDomain, TenureStats>> partials(partitions.size());
+    auto now = Clock::now();
+    
+    in.pool->run([&](unsigned worker) {
+        const auto& table = partitions[worker];
+        FlatGroups<DeptAgeDomain, TenureStats> local;
+        for (size_t i = 0; i < table.size(); ++i) {
+            auto& acc = local(table.department[i], table.age[i] / 10 - kFirstAgeGroup / 10);
+            acc.count++;
+            acc.totalSalary += table.salary[i];
+            acc.totalTenure += static_cast<double>(duration_cast<Days>(now - table.hireDate[i]).count());
+        }
+        partials[worker] = local;
+    });
+    
+    FlatGroups<DeptAgeDomain, TenureStats> total;
+    for (const auto& partial : partials) {
+        for (size_t i = 0; i < DeptAgeDomain::size; ++i) total.slots[i].merge(partial.slots[i]);
+    }
+    return ageGroupStats(total);
+}
+
+// Every worker sorts its own rows, so their strings stay on its node;
+// the caller only k-way merges the runs
+vector<PersonProjection> runStringOpsNuma(const NumaInput& in) {
+    const auto& partitions = *in.partitions;
+    vector<vector<PersonProjection>> runs(partitions.size());
+    
+    in.pool->run([&](unsigned worker) {
+        vector<PersonProjection> run;
+        g_strings.collectProjections(partitions[worker], run);
+        sortProjections(run);
+        runs[worker] = move(run);
+    });
+    
+    return mergeSortedRuns(runs);
+}
+
+vector<DepartmentAnalysis> runNestedNuma(const NumaInput& in) {
+    const auto& partitions = *in.partitions;
+    vector<array<Headcount, kDepartmentCount>> partials(partitions.size());
+    
+    in.pool->run([&](unsigned worker) {
+        const auto& table = partitions[worker];
+        array<Headcount, kDepartmentCount> local{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            auto& acc = local[table.department[i]];
+            acc.employees++;
+            if (table.salary[i] > 75000) acc.highEarners++;
+            acc.totalAge += table.age[i];
+        }
+        partials[worker] = local;
+    });
+    
+    array<Headcount, kDepartmentCount> total{};
+    for (const auto& partial : partials) {
+        for (size_t code = 0; code < kDepartmentCount; ++code) total[code].merge(partial[code]);
+    }
+    return departmentAnalysis(total);
+}
+
+vector<YoungProfessional> runProjectionNuma(const NumaInput& in) {
+    const auto& partitions = *in.partitions;
+    vector<vector<uint32_t>> candidates(partitions.size());
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    in.pool->run([&](unsigned worker) {
+        const auto& table = partitions[worker];
+        Selection filtered(table.size());
+        filtered.size = g_filters.projection(table, cutoff.time_since_epoch().count(), filtered.rows.get());
+        
+        auto byHireDate = [&](uint32_t a, uint32_t b) { return table.hireDate[a] < table.hireDate[b]; };
+        TopK<uint32_t, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+        for (uint32_t row : filtered) top.push(row);
+        candidates[worker] = top.take();
+    });
+    
+    // At most 1,000 candidates per worker, as (worker, row)
+    using Candidate = pair<unsigned, uint32_t>;
+    auto byHireDate = [&](const Candidate& a, const Candidate& b) {
+        return partitions[a.first].hireDate[a.second] < partitions[b.first].hireDate[b.second];
+    };
+    TopK<Candidate, decltype(byHireDate)> top(kProjectionLimit, byHireDate);
+    for (unsigned worker = 0; worker < candidates.size(); ++worker) {
+        for (auto row : candidates[worker]) top.push({ worker, row });
+    }
+    
+    vector<YoungProfessional> result;
+    for (auto [worker, row] : top.take()) result.push_back(youngProfessional(partitions[worker], row, now));
+    return result;
+}
+
+// Reads the columns the five tests filter and aggregate on, one load per value
+uint64_t scanColumns(const PersonTable& table) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        sum += static_cast<uint64_t>(table.age[i]) + static_cast<uint64_t>(table.salary[i]) + table.department[i] +
+            static_cast<uint64_t>(table.hireDate[i].time_since_epoch().count());
+    }
+    return sum;
+}
+
+constexpr size_t kScanBytesPerRow = sizeof(int) + sizeof(double) + sizeof(system_clock::time_point) + sizeof(uint8_t);
+
+// Runs the columnar tests on a pool pinned per NUMA node, once over slices of
+// the table the main thread built and once over partitions each worker built
+// itself, then times every node scanning its own partitions and those of the
+// next node to give the local and remote bandwidth
+void measureNuma(const vector<Person>& people, const PersonTable& table, unsigned workers) {
+    NumaPlacement placement(people, workers);
+    auto pin = placement.pinCaller();
+    auto& pool = *placement.pool;
+    const auto& nodes = placement.nodes;
+    auto shared = slicePartitions(table, pool.size());
+    
+    g_results.section = "NUMA Placement";
+    cout << "\nNUMA Placement (" << nodes.size() << (nodes.size() == 1 ? " node, " : " nodes, ")
+         << pool.size() << " workers):\n========================\n";
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        size_t rows = 0;
+        auto onNode = placement.workersOn(n);
+        for (auto w : onNode) rows += placement.partitions[w].size();
+        cout << setw(kLabelWidth) << left << "Node " + to_string(nodes[n].id) << ": "
+             << nodes[n].cpus.size() << " CPUs, " << onNode.size() << " workers, " << rows << " rows\n";
+    }
+    
+    NumaInput mainPages{ &shared, &pool };
+    NumaInput nodePages{ &placement.partitions, &pool };
+    auto compare = [&](const string& label, auto op) {
+        auto before = measure(mainPages, op);
+        auto after = measure(nodePages, op);
+        printTiming(label + " [main-thread pages]", before);
+        printTiming(label + " [node-local pages]", after, &before);
+    };
+    
+    compare("Complex LINQ Chain", runComplexOperationsNuma);
+    compare("GroupBy with Aggregation", runGroupByNuma);
+    compare("String Operations", runStringOpsNuma);
+    compare("Nested Queries", runNestedNuma);
+    compare("Projection with Where", runProjectionNuma);
+    
+    // Workers of node `reader` each scan one partition owned by node `owner`
+    auto bandwidth = [&](size_t reader, size_t owner) {
+        auto readers = placement.workersOn(reader);
+        auto owners = placement.workersOn(owner);
+        vector<size_t> source(pool.size(), pool.size());
+        size_t bytes = 0;
+        for (size_t k = 0; k < readers.size() && !owners.empty(); ++k) {
+            source[readers[k]] = owners[k % owners.size()];
+            bytes += placement.partitions[source[readers[k]]].size() * kScanBytesPerRow;
+        }
+        
+        auto t = measure(nodePages, [&](const NumaInput& in) {
+            vector<uint64_t> sums(in.pool->size());
+            in.pool->run([&](unsigned worker) {
+                if (source[worker] < sums.size()) sums[worker] = scanColumns((*in.partitions)[source[worker]]);
+            });
+            return accumulate(sums.begin(), sums.end(), uint64_t(0));
+        });
+        
+        string label = "Node " + to_string(nodes[reader].id) + " scan [" +
+            (reader == owner ? string("local") : "node " + to_string(nodes[owner].id)) + "]";
+        printTiming(label, t);
+        cout << setw(kLabelWidth) << left << "  bandwidth" << ": " << fixed << setprecision(2)
+             << static_cast<double>(bytes) / (t.avg * 1e6) << " GB/s\n";
+    };
     
-    cout << "Performance Test Results:\n========================\n";
-    measure("Complex LINQ Chain", people, runComplexOperations);
-    measure("GroupBy with Aggregation", people, runGroupBy);
-    measure("String Operations", people, runStringOps);
-    measure("Nested Queries", people, runNested);
-    measure("Projection with Where", people, runProjection);
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        bandwidth(n, n);
+        if (nodes.size() > 1) bandwidth(n, (n + 1) % nodes.size());
+    }
+}
+
+// Reference versions of the five tests: the spec's steps written out as
+// plainly as possible over std::map, with none of the optimizations above.
+// --verify compares every kernel variant against them.
+
+vector<DepartmentStats> referenceComplexOperations(const vector<Person>& people) {
+    map<string, vector<const Person*>> groups;
+    for (const auto& p : people) {
+        if (p.age > 25 && p.salary > 50000) groups[p.department].push_back(&p);
+    }
+    
+    vector<DepartmentStats> stats;
+    for (const auto& [department, members] : groups) {
+        if (members.size() <= 10) continue;
+        double totalSalary = 0, maxSalary = 0;
+        int minAge = numeric_limits<int>::max();
+        for (const auto* p : members) {
+            totalSalary += p->salary;
+            maxSalary = max(maxSalary, p->salary);
+            minAge = min(minAge, p->age);
+        }
+        stats.push_back(DepartmentStats{ department, members.size(), totalSalary / static_cast<double>(members.size()), maxSalary, minAge });
+    }
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+vector<AgeGroupStats> referenceGroupBy(const vector<Person>& people) {
+    auto now = Clock::now();
+    map<pair<string, int>, vector<const Person*>> groups;
+    for (const auto& p : people) groups[{ p.department, (p.age / 10) * 10 }].push_back(&p);
+    
+    vector<AgeGroupStats> result;
+    for (const auto& [key, members] : groups) {
+        if (members.size() <= 5) continue;
+        double totalSalary = 0, totalTenure = 0;
+        for (const auto* p : members) {
+            totalSalary += p->salary;
+            totalTenure += static_cast<double>(duration_cast<Days>(now - p->hireDate).count());
+        }
+        result.push_back(AgeGroupStats{ key.first, key.second, members.size(), totalSalary, totalTenure / static_cast<double>(members.size()) });
+    }
+    return result;
+}
+
+vector<PersonProjection> referenceStringOps(const vector<Person>& people) {
+    vector<PersonProjection> rows;
+    for (const auto& p : people) {
+        if (p.name.find('a') == string::npos && p.name.find('e') == string::npos) continue;
+        string upper;
+        for (char c : p.name) upper += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        
+        char buffer[400];
+        snprintf(buffer, sizeof(buffer), "%.2f", fabs(p.salary));
+        string salary = buffer;
+        for (auto digits = salary.find('.'); digits != string::npos && digits > 3; digits -= 3) salary.insert(digits - 3, ",");
+        salary = (p.salary < 0 ? "-$" : "$") + salary;
+        
+        bool manager = p.salary > 100000 || (p.name.size() >= 7 && p.name.substr(p.name.size() - 7) == "Manager");
+        if (upper.size() > 5) rows.push_back(PersonProjection{ p.id, upper, p.name.size(), salary, manager });
+    }
+    sort(rows.begin(), rows.end(), [](const PersonProjection& a, const PersonProjection& b) {
+        return tie(a.upperName, a.id) < tie(b.upperName, b.id);
+    });
+    return rows;
+}
+
+vector<DepartmentAnalysis> referenceNested(const vector<Person>& people) {
+    set<string> departments;
+    for (const auto& p : people) departments.insert(p.department);
+    
+    vector<DepartmentAnalysis> analysis;
+    for (const auto& department : departments) {
+        size_t employees = 0;
+        size_t highEarners = 0;
+        double totalAge = 0;
+        for (const auto& p : people) {
+            if (p.department != department) continue;
+            employees++;
+            if (p.salary > 75000) highEarners++;
+            totalAge += p.age;
+        }
+        if (employees > 50) analysis.push_back(DepartmentAnalysis{ department, employees, highEarners, totalAge / static_cast<double>(employees) });
+    }
+    sortDepartmentAnalysis(analysis);
+    return analysis;
+}
+
+vector<YoungProfessional> referenceProjection(const vector<Person>& people) {
+    auto now = Clock::now();
+    auto cutoff = now - Days(static_cast<int>(365.25 * 5));
+    
+    vector<YoungProfessional> result;
+    for (const auto& p : people) {
+        if (p.hireDate <= cutoff) continue;
+        auto row = youngProfessional(p, now);
+        if (row.isYoungProfessional) result.push_back(row);
+    }
+    stable_sort(result.begin(), result.end(),
+        [](const YoungProfessional& a, const YoungProfessional& b) { return a.yearsOfService > b.yearsOfService; });
+    if (result.size() > kProjectionLimit) result.resize(kProjectionLimit);
+    return result;
+}
+
+vector<DepartmentStats> referenceCostCenters(const vector<Person>& people, const vector<uint32_t>& costCenter) {
+    map<uint32_t, vector<const Person*>> groups;
+    for (size_t i = 0; i < people.size(); ++i) {
+        const auto& p = people[i];
+        if (p.age > 25 && p.salary > 50000) groups[costCenter[i]].push_back(&p);
+    }
+    
+    vector<DepartmentStats> stats;
+    for (const auto& [key, members] : groups) {
+        if (members.size() <= 10) continue;
+        double totalSalary = 0, maxSalary = 0;
+        int minAge = numeric_limits<int>::max();
+        for (const auto* p : members) {
+            totalSalary += p->salary;
+            maxSalary = max(maxSalary, p->salary);
+            minAge = min(minAge, p->age);
+        }
+        stats.push_back(DepartmentStats{ costCenterName(key), members.size(), totalSalary / static_cast<double>(members.size()), maxSalary, minAge });
+    }
+    sortDepartmentStats(stats);
+    return stats;
+}
+
+// Runs every kernel variant once and compares its result with the reference
+// versions: sums to a relative 1e-9, tenures to a day and years of service to
+// a day. Prints one line per variant and returns the number of mismatches.
+int verifyResults(const vector<Person>& people, const PersonTable& table) {
+    const auto complex = referenceComplexOperations(people);
+    const auto groupBy = referenceGroupBy(people);
+    const auto strings = referenceStringOps(people);
+    const auto nested = referenceNested(people);
+    const auto projection = referenceProjection(people);
+    
+    int mismatches = 0;
+    auto check = [&](const string& label, bool same) {
+        cout << setw(kLabelWidth) << left << label << ": " << (same ? "OK" : "MISMATCH") << "\n";
+        if (!same) mismatches++;
+    };
+    
+    cout << "Verification against the reference implementation:\n========================\n";
+    
+    auto checkRows = [&](const string& layout, const auto& rows) {
+        check("Complex LINQ Chain [" + layout + "]", sameDepartmentStats(runComplexOperations(rows), complex));
+        check("Complex LINQ Chain [" + layout + ", index runs]", sameDepartmentStats(runComplexOperationsIndexed(rows), complex));
+        check("GroupBy with Aggregation [" + layout + "]", sameAgeGroupStats(runGroupBy(rows), groupBy));
+        check("GroupBy with Aggregation [" + layout + ", flat]", sameAgeGroupStats(runGroupByFlat(rows), groupBy));
+        check("String Operations [" + layout + "]", samePersonProjections(runStringOps(rows), strings));
+        check("Nested Queries [" + layout + "]", sameDepartmentAnalysis(runNested(rows), nested));
+        check("Nested Queries [" + layout + ", single pass]", sameDepartmentAnalysis(runNestedSinglePass(rows), nested));
+        check("Projection with Where [" + layout + "]", sameYoungProfessionals(runProjection(rows), projection));
+    };
+    checkRows("rows", people);
+    checkRows("inline names", toInlineLayout(people));
+    auto pooled = toPooledLayout(people);
+    checkRows("pooled names", pooled.rows);
+    
+    // The columnar kernels once per supported filter and string kernel level,
+    // and the packed ones when every column fits in PackedColumn::kMaxBits
+    PackedTable packed{};
+    bool packable = true;
+    try {
+        packed = packTable(table);
+    } catch (const runtime_error& e) {
+        cout << "Packed kernels: skipped, " << e.what() << "\n";
+        packable = false;
+    }
+    const auto filters = g_filters;
+    const auto stringKernels = g_strings;
+    for (auto level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (level > detectSimdLevel()) break;
+        g_filters = filterKernelsFor(level);
+        g_strings = stringKernelsFor(level);
+        const string suffix = string(", ") + simdLevelName(level) + "]";
+        check("Complex LINQ Chain [SoA" + suffix, sameDepartmentStats(runComplexOperationsSoA(table), complex));
+        check("GroupBy with Aggregation [SoA" + suffix, sameAgeGroupStats(runGroupBySoA(table), groupBy));
+        check("GroupBy with Aggregation [SoA, flat" + suffix, sameAgeGroupStats(runGroupByFlatSoA(table), groupBy));
+        check("GroupBy with Aggregation [SoA, days" + suffix, sameAgeGroupStats(runGroupByDaysSoA(table), groupBy, Tenure::Days));
+        check("GroupBy with Aggregation [SoA, flat, days" + suffix, sameAgeGroupStats(runGroupByFlatDaysSoA(table), groupBy, Tenure::Days));
+        check("String Operations [SoA" + suffix, samePersonProjections(runStringOpsSoA(table), strings));
+        check("Nested Queries [SoA" + suffix, sameDepartmentAnalysis(runNestedSoA(table), nested));
+        check("Nested Queries [SoA, single pass" + suffix, sameDepartmentAnalysis(runNestedSinglePassSoA(table), nested));
+        check("Projection with Where [SoA" + suffix, sameYoungProfessionals(runProjectionSoA(table), projection));
+        check("Projection with Where [SoA, days" + suffix, sameYoungProfessionals(runProjectionDaysSoA(table), projection, Tenure::Days));
+        if (!packable) continue;
+        check("Complex LINQ Chain [packed" + suffix, sameDepartmentStats(runComplexOperationsPacked(packed), complex));
+        check("GroupBy with Aggregation [packed" + suffix, sameAgeGroupStats(runGroupByPacked(packed), groupBy, Tenure::Days));
+        check("Nested Queries [packed" + suffix, sameDepartmentAnalysis(runNestedPacked(packed), nested));
+        check("Projection with Where [packed" + suffix, sameYoungProfessionals(runProjectionPacked(packed), projection, Tenure::Days));
+    }
+    g_filters = filters;
+    g_strings = stringKernels;
+    
+    const auto sortEngines = g_sort;
+    g_sort.complex = g_sort.strings = SortEngine::Radix;
+    check("Complex LINQ Chain [radix]", sameDepartmentStats(runComplexOperations(people), complex));
+    check("Complex LINQ Chain [SoA, radix]", sameDepartmentStats(runComplexOperationsSoA(table), complex));
+    check("String Operations [radix]", samePersonProjections(runStringOps(people), strings));
+    check("String Operations [SoA, radix]", samePersonProjections(runStringOpsSoA(table), strings));
+    g_sort = sortEngines;
+    
+    // At least two threads, so the per-thread partials are really merged
+    ThreadPool pool(max(2u, thread::hardware_concurrency()));
+    ParallelInput parallel{ &people, &pool };
+    check("Complex LINQ Chain [parallel]", sameDepartmentStats(runComplexOperationsParallel(parallel), complex));
+    check("Complex LINQ Chain [stealing]", sameDepartmentStats(runComplexOperationsStealing(parallel), complex));
+    check("GroupBy with Aggregation [parallel]", sameAgeGroupStats(runGroupByParallel(parallel), groupBy));
+    check("GroupBy with Aggregation [stealing]", sameAgeGroupStats(runGroupByStealing(parallel), groupBy));
+    check("String Operations [parallel]", samePersonProjections(runStringOpsParallel(parallel), strings));
+    check("String Operations [stealing]", samePersonProjections(runStringOpsStealing(parallel), strings));
+    check("Nested Queries [parallel]", sameDepartmentAnalysis(runNestedParallel(parallel), nested));
+    check("Projection with Where [parallel]", sameYoungProfessionals(runProjectionParallel(parallel), projection));
+    
+    NumaPlacement placement(people, max(2u, thread::hardware_concurrency()));
+    auto pin = placement.pinCaller();
+    NumaInput numa{ &placement.partitions, placement.pool.get() };
+    check("Complex LINQ Chain [NUMA]", sameDepartmentStats(runComplexOperationsNuma(numa), complex));
+    check("GroupBy with Aggregation [NUMA]", sameAgeGroupStats(runGroupByNuma(numa), groupBy));
+    check("String Operations [NUMA]", samePersonProjections(runStringOpsNuma(numa), strings));
+    check("Nested Queries [NUMA]", sameDepartmentAnalysis(runNestedNuma(numa), nested));
+    check("Projection with Where [NUMA]", sameYoungProfessionals(runProjectionNuma(numa), projection));
+    
+    auto scanned = runSharedScan(SharedScanInput{ &table, kScanAll });
+    check("Complex LINQ Chain [shared scan]", sameDepartmentStats(scanned.complex, complex));
+    check("GroupBy with Aggregation [shared scan]", sameAgeGroupStats(scanned.groupBy, groupBy));
+    check("String Operations [shared scan]", samePersonProjections(scanned.strings, strings));
+    check("Nested Queries [shared scan]", sameDepartmentAnalysis(scanned.nested, nested));
+    check("Projection with Where [shared scan]", sameYoungProfessionals(scanned.projection, projection));
+    
+    Arena arena;
+    ArenaInput pooledInput{ &people, &arena };
+    check("Complex LINQ Chain [arena]", sameDepartmentStats(runComplexOperationsArena(pooledInput), complex));
+    check("GroupBy with Aggregation [arena]", sameAgeGroupStats(runGroupByArena(pooledInput), groupBy));
+    check("String Operations [arena]", samePersonProjections(stringOpsArenaResult(pooledInput), strings));
+    check("Nested Queries [arena]", sameDepartmentAnalysis(runNestedArena(pooledInput), nested));
+    check("Projection with Where [arena]", sameYoungProfessionals(runProjectionArena(pooledInput), projection));
+    
+    check("Complex LINQ Chain [pipeline]", sameDepartmentStats(runComplexOperationsPipeline(people), complex));
+    check("GroupBy with Aggregation [pipeline]", sameAgeGroupStats(runGroupByPipeline(people), groupBy));
+    check("String Operations [pipeline]", samePersonProjections(runStringOpsPipeline(people), strings));
+    check("Nested Queries [pipeline]", sameDepartmentAnalysis(runNestedPipeline(people), nested));
+    check("Projection with Where [pipeline]", sameYoungProfessionals(runProjectionPipeline(people), projection));
+    
+    // Four chunks, so every streaming consumer merges partial states
+    StreamingComplex streamingComplex;
+    StreamingGroupBy streamingGroupBy;
+    StreamingStringOps streamingStrings;
+    StreamingNested streamingNested;
+    StreamingProjection streamingProjection;
+    const size_t chunkRows = people.size() / 4 + 1;
+    for (size_t done = 0; done < people.size(); done += chunkRows) {
+        vector<Person> chunk(people.begin() + static_cast<ptrdiff_t>(done),
+            people.begin() + static_cast<ptrdiff_t>(min(people.size(), done + chunkRows)));
+        streamingComplex.consume(chunk);
+        streamingGroupBy.consume(chunk);
+        streamingStrings.consume(chunk);
+        streamingNested.consume(chunk);
+        streamingProjection.consume(chunk);
+    }
+    check("Complex LINQ Chain [streaming]", sameDepartmentStats(streamingComplex.finish(), complex));
+    check("GroupBy with Aggregation [streaming]", sameAgeGroupStats(streamingGroupBy.finish(), groupBy));
+    check("String Operations [streaming]", samePersonProjections(streamingStrings.finish(), strings));
+    check("Nested Queries [streaming]", sameDepartmentAnalysis(streamingNested.finish(), nested));
+    check("Projection with Where [streaming]", sameYoungProfessionals(streamingProjection.finish(), projection));
+    
+    // Insert every row, then erase the first tenth, which also exercises the
+    // max salary and min age recovery after an erase
+    IncrementalStats store;
+    for (const auto& p : people) store.insert(p);
+    const auto kept = people.size() - people.size() / 10;
+    for (size_t i = 0; i < people.size() - kept; ++i) store.erase(people[i]);
+    vector<Person> window(people.end() - static_cast<ptrdiff_t>(kept), people.end());
+    check("Complex LINQ Chain [incremental]", sameDepartmentStats(store.departmentStats(), referenceComplexOperations(window)));
+    check("GroupBy with Aggregation [incremental]", sameAgeGroupStats(store.groupStats(epochDay(Clock::now())), referenceGroupBy(window), Tenure::Days));
+    
+    TableIndexes indexes{ buildAgeIndex(table), buildSalaryIndex(table), buildHireDateIndex(table) };
+    IndexInput indexed{ &table, &indexes };
+    auto indexRows = [&](const vector<uint32_t>& rows) {
+        auto now = Clock::now();
+        vector<YoungProfessional> result;
+        for (auto row : rows) result.push_back(youngProfessional(table, row, now));
+        return result;
+    };
+    check("Complex LINQ Chain [salary index]", sameDepartmentStats(runComplexOperationsSalaryIndex(indexed), complex));
+    check("Projection with Where [age index]", sameYoungProfessionals(indexRows(runProjectionAgeIndex(indexed)), projection));
+    check("Projection with Where [hireDate index]", sameYoungProfessionals(indexRows(runProjectionHireDateIndex(indexed)), projection));
+    
+    // Thousands of cost centers, so every radix partition holds many groups
+    auto costCenter = generateCostCenters(table.size(), 10'000, 0);
+    const auto costCenters = referenceCostCenters(people, costCenter);
+    ThreadPool costCenterPool(max(2u, thread::hardware_concurrency()));
+    CostCenterInput costCenterInput{ &table, &costCenter, &costCenterPool };
+    check("Cost centers [node map]", sameDepartmentStats(runCostCenterNodeMap(costCenterInput), costCenters));
+    check("Cost centers [open addressing]", sameDepartmentStats(runCostCenterHash(costCenterInput), costCenters));
+    check("Cost centers [radix partitioned]", sameDepartmentStats(runCostCenterPartitioned(costCenterInput), costCenters));
+    
+    cout << (mismatches == 0 ? "All variants match the reference\n" : to_string(mismatches) + " variants do not match the reference\n");
+    return mismatches;
+}
+
+// Data cache capacities in bytes, 0 where the platform does not say
+struct CacheSizes {
+    size_t l2 = 0;
+    size_t l3 = 0;
+};
+
+CacheSizes detectCacheSizes() {
+    CacheSizes sizes;
+#if defined(_WIN32)
+    DWORD bytes = 0;
+    GetLogicalProcessorInformation(nullptr, &bytes);
+    vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &bytes)) {
+        for (const auto& entry : info) {
+            if (entry.Relationship != RelationCache || entry.Cache.Type == CacheInstruction) continue;
+            if (entry.Cache.Level == 2) sizes.l2 = max<size_t>(sizes.l2, entry.Cache.Size);
+            if (entry.Cache.Level == 3) sizes.l3 = max<size_t>(sizes.l3, entry.Cache.Size);
+        }
+    }
+#elif defined(__linux__)
+    // One directory per cache of CPU 0: level, type and size ("2048K")
+    for (int index = 0; index < 16; ++index) {
+        string dir = "/sys/devices/system/cpu/cpu0/cache/index" + to_string(index) + "/";
+        ifstream levelFile(dir + "level"), typeFile(dir + "type"), sizeFile(dir + "size");
+        int level = 0;
+        string type, size;
+        if (!(levelFile >> level) || !(typeFile >> type) || !(sizeFile >> size)) break;
+        if (type == "Instruction" || size.empty()) continue;
+        
+        size_t bytes = stoull(size);
+        if (size.back() == 'K') bytes <<= 10;
+        else if (size.back() == 'M') bytes <<= 20;
+        if (level == 2) sizes.l2 = bytes;
+        if (level == 3) sizes.l3 = bytes;
+    }
+#endif
+    return sizes;
+}
+
+// Every column of the table, whichever of them a test reads
+size_t footprint(const PersonTable& table) {
+    return table.id.size() * sizeof(int) + table.age.size() * sizeof(int) + table.salary.size() * sizeof(double)
+        + table.hireDate.size() * sizeof(system_clock::time_point) + table.hireDay.size() * sizeof(int32_t)
+        + table.department.size() + table.nameOffset.size() * sizeof(uint32_t) + table.nameHeap.size();
+}
+
+// Smallest cache level that holds bytes
+const char* cacheTier(size_t bytes, const CacheSizes& caches) {
+    if (caches.l2 > 0 && bytes <= caches.l2) return "L2";
+    if (caches.l3 > 0 && bytes <= caches.l3) return "L3";
+    return caches.l3 > 0 || caches.l2 > 0 ? "DRAM" : "?";
+}
+
+// Runs the five tests at 1, 2 and 5 times every power of ten from 1,000 up to
+// maxRows and prints the median ns per row of both layouts. A marker line
+// goes before the first size whose dataset no longer fits the cache level
+// above it. Every size gets a fresh dataset, so only one is in memory.
+void measureSweep(size_t maxRows, const GeneratorOptions& genOpts) {
+    // Small sizes finish in microseconds, so every point is repeated for at
+    // least this long unless --budget already asks for more
+    constexpr double kSweepBudgetMs = 50;
+    auto config = g_bench;
+    g_bench.budgetMs = max(g_bench.budgetMs, kSweepBudgetMs);
+    
+    vector<size_t> sizes;
+    for (size_t decade = 1000; decade <= maxRows; decade *= 10) {
+        for (size_t step : { 1, 2, 5 }) {
+            if (decade * step <= maxRows) sizes.push_back(decade * step);
+        }
+    }
+    if (sizes.empty() || sizes.back() != maxRows) sizes.push_back(maxRows);
+    
+    auto caches = detectCacheSizes();
+    auto megabytes = [](size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    
+    g_results.section = "Size Sweep";
+    cout << "Size Sweep (median ns/row; L2 " << fixed << setprecision(2) << megabytes(caches.l2)
+         << "MB, L3 " << megabytes(caches.l3) << "MB):\n========================\n";
+    cout << right << setw(11) << "Rows" << setw(8) << "Layout" << setw(12) << "Data MB" << setw(6) << "Fits"
+         << setw(10) << "Complex" << setw(10) << "GroupBy" << setw(10) << "Strings" << setw(10) << "Nested"
+         << setw(12) << "Projection" << "\n";
+    
+    const char* previousTier[2] = { nullptr, nullptr };
+    for (auto rows : sizes) {
+        auto people = generateTestData(static_cast<int>(rows), genOpts);
+        auto table = toColumnar(people);
+        
+        const Timing timings[2][5] = {
+            { measure(people, runComplexOperations<Person>), measure(people, runGroupBy<Person>),
+              measure(people, runStringOps<Person>), measure(people, runNested<Person>), measure(people, runProjection<Person>) },
+            { measure(table, runComplexOperationsSoA), measure(table, runGroupBySoA),
+              measure(table, runStringOpsSoA), measure(table, runNestedSoA), measure(table, runProjectionSoA) },
+        };
+        const size_t bytes[2] = { footprint(people), footprint(table) };
+        const char* layouts[2] = { "AoS", "SoA" };
+        const char* tests[5] = { "Complex LINQ Chain", "GroupBy with Aggregation", "String Operations",
+            "Nested Queries", "Projection with Where" };
+        
+        for (int layout = 0; layout < 2; ++layout) {
+            for (int test = 0; test < 5; ++test) g_results.add(tests[test], layouts[layout], rows, timings[layout][test]);
+            
+            const char* tier = cacheTier(bytes[layout], caches);
+            if (previousTier[layout] && strcmp(tier, previousTier[layout]) != 0) {
+                cout << "---- " << layouts[layout] << " data exceeds " << previousTier[layout] << " ----\n";
+            }
+            previousTier[layout] = tier;
+            
+            cout << right << setw(11) << rows << setw(8) << layouts[layout]
+                 << setw(12) << fixed << setprecision(2) << megabytes(bytes[layout]) << setw(6) << tier;
+            for (int test = 0; test < 5; ++test) {
+                cout << setw(test == 4 ? 12 : 10) << timings[layout][test].median * 1e6 / static_cast<double>(rows);
+            }
+            cout << "\n";
+        }
+    }
+    
+    g_bench = config;
+}
+
+string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(_MSC_VER)
+    return "msvc " + to_string(_MSC_FULL_VER);
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+string cpuModel() {
+    string model;
+#if BW_X86
+    // Brand string from the three extended cpuid leaves
+    unsigned regs[12] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, static_cast<int>(0x80000000));
+    if (static_cast<unsigned>(info[0]) < 0x80000004) return "unknown";
+    for (int leaf = 0; leaf < 3; ++leaf) __cpuid(reinterpret_cast<int*>(regs + 4 * leaf), static_cast<int>(0x80000002 + leaf));
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000004) return "unknown";
+    for (unsigned leaf = 0; leaf < 3; ++leaf) {
+        __get_cpuid(0x80000002 + leaf, &regs[4 * leaf], &regs[4 * leaf + 1], &regs[4 * leaf + 2], &regs[4 * leaf + 3]);
+    }
+#endif
+    char brand[sizeof(regs) + 1] = {};
+    memcpy(brand, regs, sizeof(regs));
+    model = brand;
+#elif defined(__linux__)
+    ifstream cpuinfo("/proc/cpuinfo");
+    for (string line; getline(cpuinfo, line);) {
+        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+            model = line.substr(line.find(':') + 1);
+            break;
+        }
+    }
+#endif
+    auto first = model.find_first_not_of(' ');
+    if (first == string::npos) return "unknown";
+    return model.substr(first, model.find_last_not_of(' ') - first + 1);
+}
+
+const char* osName() {
+#if defined(_WIN32)
+    return "Windows";
+#elif defined(__linux__)
+    return "Linux";
+#elif defined(__APPLE__)
+    return "macOS";
+#else
+    return "unknown";
+#endif
+}
+
+// Describes the build, machine and settings a result file came from, in a
+// fixed order so two files diff line by line
+vector<pair<string, string>> resultEnvironment(const string& arguments) {
+    auto now = system_clock::to_time_t(system_clock::now());
+    tm utc{};
+#if defined(_WIN32)
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    ostringstream timestamp;
+    timestamp << put_time(&utc, "%Y-%m-%dT%H:%M:%SZ");
+    
+#if defined(_MSVC_LANG)
+    auto standard = static_cast<long>(_MSVC_LANG);
+#else
+    auto standard = static_cast<long>(__cplusplus);
+#endif
+    
+    return {
+        { "timestamp", timestamp.str() },
+        { "compiler", compilerName() },
+        { "buildFlags", BW_BUILD_FLAGS },
+        { "cppStandard", to_string(standard) },
+        { "os", osName() },
+        { "cpu", cpuModel() },
+        { "logicalCores", to_string(thread::hardware_concurrency()) },
+        { "arguments", arguments },
+        { "filterKernels", simdLevelName(g_filters.level) },
+        { "stringKernels", simdLevelName(g_strings.level) },
+        { "sortComplex", sortEngineName(g_sort.complex) },
+        { "sortStrings", sortEngineName(g_sort.strings) },
+        { "warmups", to_string(g_bench.warmups) },
+        { "runs", to_string(g_bench.runs) },
+        { "budgetMs", to_string(g_bench.budgetMs) },
+        { "pinCpu", to_string(g_bench.pinCpu) },
+        { "counters", g_counters ? "on" : "off" },
+    };
+}
+
+string jsonString(const string& text) {
+    ostringstream out;
+    out << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c < 0x20) out << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec << setfill(' ');
+        else out << c;
+    }
+    out << '"';
+    return out.str();
+}
+
+string csvField(const string& text) {
+    if (text.find_first_of(",\"\n") == string::npos) return text;
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Milliseconds to a tenth of a microsecond, counters to whole events
+constexpr int kResultPrecision = 4;
+
+// One object per line: the environment, then every result with its samples
+void writeJsonResults(const string& path, const string& arguments) {
+    ofstream out(path);
+    if (!out) throw runtime_error("cannot create " + path);
+    out << fixed << setprecision(kResultPrecision);
+    
+    auto counter = [](double value) {
+        if (value < 0) return string("null");
+        ostringstream text;
+        text << fixed << setprecision(0) << value;
+        return text.str();
+    };
     
+    out << "{\n  \"environment\": {";
+    const char* separator = "\n";
+    for (const auto& [key, value] : resultEnvironment(arguments)) {
+        out << separator << "    " << jsonString(key) << ": " << jsonString(value);
+        separator = ",\n";
+    }
+    out << "\n  },\n  \"results\": [";
+    
+    separator = "\n";
+    for (const auto& r : g_results.records) {
+        const auto& t = r.timing;
+        out << separator << "    { \"section\": " << jsonString(r.section) << ", \"name\": " << jsonString(r.name)
+            << ", \"variant\": " << jsonString(r.variant) << ", \"rows\": " << r.rows
+            << ", \"avgMs\": " << t.avg << ", \"medianMs\": " << t.median << ", \"p95Ms\": " << t.p95
+            << ", \"minMs\": " << t.min << ", \"maxMs\": " << t.max << ", \"stddevMs\": " << t.stddev
+            << ", \"ci95Ms\": " << t.ci95 << ", \"runs\": " << t.runs << ", \"outliers\": " << t.outliers
+            << ", \"allocations\": " << t.allocations << ", \"allocatedBytes\": " << t.allocatedBytes
+            << ", \"instructions\": " << counter(t.counters.instructions) << ", \"cycles\": " << counter(t.counters.cycles)
+            << ", \"llcMisses\": " << counter(t.counters.llcMisses) << ", \"branchMisses\": " << counter(t.counters.branchMisses)
+            << ", \"samplesMs\": [";
+        for (size_t i = 0; i < t.samples.size(); ++i) out << (i ? ", " : "") << t.samples[i];
+        out << "] }";
+        separator = ",\n";
+    }
+    out << "\n  ]\n}\n";
+    if (!out) throw runtime_error("cannot write " + path);
+}
+
+// One row per timed run, with the summary of its test repeated on each row.
+// The environment goes first as "# key,value" comment lines.
+void writeCsvResults(const string& path, const string& arguments) {
+    ofstream out(path);
+    if (!out) throw runtime_error("cannot create " + path);
+    out << fixed << setprecision(kResultPrecision);
+    
+    for (const auto& [key, value] : resultEnvironment(arguments)) {
+        out << "# " << key << "," << csvField(value) << "\n";
+    }
+    
+    auto counter = [](double value) {
+        if (value < 0) return string();
+        ostringstream text;
+        text << fixed << setprecision(0) << value;
+        return text.str();
+    };
+    
+    out << "section,name,variant,rows,iteration,time_ms,avg_ms,median_ms,p95_ms,min_ms,max_ms,ci95_ms,"
+        << "allocations,allocated_bytes,instructions,cycles,llc_misses,branch_misses\n";
+    for (const auto& r : g_results.records) {
+        const auto& t = r.timing;
+        for (size_t i = 0; i < t.samples.size(); ++i) {
+            out << csvField(r.section) << "," << csvField(r.name) << "," << csvField(r.variant) << "," << r.rows << ","
+                << i + 1 << "," << t.samples[i] << "," << t.avg << "," << t.median << "," << t.p95 << ","
+                << t.min << "," << t.max << "," << t.ci95 << "," << t.allocations << "," << t.allocatedBytes << ","
+                << counter(t.counters.instructions) << "," << counter(t.counters.cycles) << ","
+                << counter(t.counters.llcMisses) << "," << counter(t.counters.branchMisses) << "\n";
+        }
+    }
+    if (!out) throw runtime_error("cannot write " + path);
+}
+
+struct Options {
+    // Rows in the generated dataset
+    size_t rows = 1'000'000;
+    
+    // Map the dataset from this binary file instead of generating it
+    string dataPath;
+    
+    // Write the dataset to this binary file before running the tests
+    string writePath;
+    
+    // When non-zero, generate the dataset (or read --data) in chunks of this
+    // many rows and run only the streaming kernels, holding only a few chunks
+    size_t streamChunk = 0;
+    
+    // --stream: chunks a loader thread may produce ahead of the consumers; 0
+    // loads every chunk on the consuming thread between the consumer runs
+    size_t streamQueue = 0;
+    
+    // When non-zero, run only the size sweep, from 1,000 up to this many rows
+    size_t sweepRows = 0;
+    
+    // Nested Queries: rescan per department (what the other languages do) or one pass
+    bool singlePassNested = false;
+    
+    // Complex chain: group by copying Person into per-department vectors (default) or by index runs
+    bool indexedGrouping = false;
+    
+    // Columnar GroupBy and Projection read hire dates as int32 epoch days instead of time points
+    bool epochDays = false;
+    
+    // GroupBy: collect member lists per group (default) or fold into a compile-time sized array
+    bool flatGroupBy = false;
+    
+    // When non-zero, also run the parallel kernels at 1, 2, 4, ... up to this many threads
+    unsigned threads = 0;
+    
+    // Parallel mode: run group aggregations and sorts through the work-stealing scheduler
+    bool workStealing = false;
+    
+    GeneratorOptions generator;
+    
+    // Generate in parallel blocks with per-block random streams instead of one mt19937 sequence
+    bool blockedGenerator = false;
+    
+    // Also compare the row kernels against their arena-allocated versions
+    bool arena = false;
+    
+    // Also run the row kernels over the inline-name and pooled-name layouts
+    bool nameLayouts = false;
+    
+    // Also compare the row kernels against the fused pipeline versions
+    bool pipelines = false;
+    
+    // When non-zero, also time incremental aggregate maintenance for batches of this many rows
+    size_t incrementalBatch = 0;
+    
+    // Also build sorted secondary indexes and time the range-predicate tests through them
+    bool secondaryIndexes = false;
+    
+    // Also run the columnar tests on workers pinned per NUMA node over node-local partitions
+    bool numa = false;
+    
+    // Also time the five tests as one shared scan against five separate scans
+    bool sharedScan = false;
+    
+    // Also run the columnar tests over bit-packed frame-of-reference columns
+    bool packed = false;
+    
+    // When non-zero, also time the Complex chain grouped by this many cost centers
+    size_t costCenters = 0;
+    
+    // SIMD level of the columnar filter and string kernels; defaults to the best the CPU supports
+    SimdLevel simd = detectSimdLevel();
+    
+    // Also time the filter kernels on their own for every supported level
+    bool compareFilters = false;
+    
+    // Sort used by the Complex Operations and String Operations tests
+    SortEngines sort;
+    
+    // Warm-up and timed runs per test
+    BenchmarkConfig bench;
+    
+    // Also read hardware performance counters around every timed run
+    bool counters = false;
+    
+    // Only check every kernel variant against the reference implementation
+    bool verify = false;
+    
+    // Write every result to these files when set
+    string jsonPath;
+    string csvPath;
+};
+
+void printUsage() {
+    cout << "Usage: program [options]\n"
+         << "  --rows N               Rows in the generated dataset (default: 1000000)\n"
+         << "  --data FILE            Map the dataset from a binary dataset file instead of generating it\n"
+         << "  --write-data FILE      Write the dataset to a binary dataset file (see spec.md)\n"
+         << "  --stream CHUNK         Generate the rows (or read the --data file) in chunks of CHUNK rows\n"
+         << "                         and run only the streaming kernels, which fold each chunk into\n"
+         << "                         mergeable partial results\n"
+         << "  --overlap DEPTH        With --stream, load chunks on a separate thread up to DEPTH chunks\n"
+         << "                         ahead of the consumers, overlapping loading with computation\n"
+         << "  --sweep MAX            Run only a size sweep: the five tests at 1K, 2K, 5K, 10K, ... up to\n"
+         << "                         MAX rows, in ns/row, marking where the data outgrows L2 and L3\n"
+         << "  --nested scan|single   Nested Queries algorithm: one scan per department (default)\n"
+         << "                         or a single pass with per-department accumulators\n"
+         << "  --grouping copy|index  Complex chain grouping: copy rows into per-department vectors (default)\n"
+         << "                         or group by runs of sorted row indices\n"
+         << "  --groupby lists|flat   GroupBy test: collect member lists per group (default) or fold rows\n"
+         << "                         into a flat array over the compile-time (department, decade) domain\n"
+         << "  --dates timepoint|days Columnar GroupBy and Projection hire dates: system_clock time points\n"
+         << "                         (default) or int32 days since the epoch; days results are at day\n"
+         << "                         resolution and can differ by a day from the time-point ones\n"
+         << "  --threads N            Also run the parallel kernels, scaling from 1 up to N threads\n"
+         << "  --scheduler static|stealing\n"
+         << "                         Parallel group aggregation and sorts: static partitions (default)\n"
+         << "                         or the work-stealing scheduler\n"
+         << "  --generator sequential|blocked\n"
+         << "                         Data generator: one mt19937 sequence (default) or parallel blocks with\n"
+         << "                         per-block random streams, identical for any thread count (uses\n"
+         << "                         --threads threads, or all hardware threads)\n"
+         << "  --zipf S               Draw departments from a Zipf distribution with exponent S\n"
+         << "  --alloc heap|arena     Also run the row kernels with per-iteration arena allocation\n"
+         << "  --name-layouts         Also run the row kernels with inline and pooled name storage\n"
+         << "  --incremental BATCH    Also time keeping the Complex and GroupBy results current while\n"
+         << "                         BATCH rows are appended and expired, against full recomputes\n"
+         << "  --indexes              Also build sorted age, salary and hireDate indexes and time the\n"
+         << "                         Complex and Projection tests through them, with break-even counts\n"
+         << "  --pipelines            Also run the five tests as fused where/groupBy/topN pipelines\n"
+         << "  --shared-scan          Also run the five tests as one blocked pass over the columns that\n"
+         << "                         feeds every query, against one pass per query\n"
+         << "  --packed               Also run the columnar tests directly on bit-packed frame-of-reference\n"
+         << "                         age, salary, hireDay and department columns\n"
+         << "  --groups N             Also time the Complex chain grouped by a cost center column with N\n"
+         << "                         distinct values (Zipf with --zipf) through a node-based map, an\n"
+         << "                         open-addressing table and a radix-partitioned parallel version\n"
+         << "                         (uses --threads threads, or all hardware threads)\n"
+         << "  --numa                 Also run the columnar tests on workers pinned per NUMA node, each\n"
+         << "                         owning a partition it built itself, and report per-node local and\n"
+         << "                         remote scan bandwidth (uses --threads threads, or all hardware threads)\n"
+         << "  --verify               Only run every kernel variant once and compare its result with a\n"
+         << "                         plain reference implementation; exits with 1 on any mismatch\n"
+         << "  --simd auto|scalar|sse2|avx2|avx512|compare\n"
+         << "                         Filter and string kernels used by the columnar tests (default: best\n"
+         << "                         supported); compare also times every supported kernel on its own\n"
+         << "  --json FILE            Write every result with its samples and the build and machine\n"
+         << "                         details to FILE as JSON\n"
+         << "  --csv FILE             The same as CSV, one row per timed run\n"
+         << "  --warmup N             Untimed runs before each test (default: 1)\n"
+         << "  --runs N               Timed runs per test (default: 5)\n"
+         << "  --budget MS            Keep repeating each test past --runs until MS milliseconds have\n"
+         << "                         been timed (at most " << kMaxRuns << " runs)\n"
+         << "  --counters             Report instructions, cycles, IPC, LLC misses and branch misses\n"
+         << "                         per test from the hardware performance counters\n"
+         << "  --pin CPU              Pin the measuring thread to CPU while it times a test (not with --numa)\n"
+         << "  --sort std|radix       Sort engine for the complex chain and string tests (default: std)\n"
+         << "  --sort-complex std|radix, --sort-strings std|radix\n"
+         << "                         Sort engine for one of the two tests\n";
+}
+
+SortEngine parseSortEngine(const string& option, const string& mode) {
+    if (mode == "std") return SortEngine::Comparison;
+    if (mode == "radix") return SortEngine::Radix;
+    throw invalid_argument("unknown " + option + " engine: " + mode);
+}
+
+// Row counts are stored in int ids, so both options are capped at INT_MAX
+size_t parseRowCount(const string& option, const string& text) {
+    auto count = stoull(text);
+    if (count == 0 || count > static_cast<unsigned long long>(numeric_limits<int>::max())) {
+        throw invalid_argument(option + " must be between 1 and " + to_string(numeric_limits<int>::max()));
+    }
+    return static_cast<size_t>(count);
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw invalid_argument("missing value for " + arg);
+            return argv[++i];
+        };
+        
+        if (arg == "--rows") {
+            options.rows = parseRowCount(arg, value());
+        } else if (arg == "--data") {
+            options.dataPath = value();
+        } else if (arg == "--write-data") {
+            options.writePath = value();
+        } else if (arg == "--stream") {
+            options.streamChunk = parseRowCount(arg, value());
+        } else if (arg == "--overlap") {
+            auto depth = stoi(value());
+            if (depth < 1 || depth > 64) throw invalid_argument("--overlap must be between 1 and 64");
+            options.streamQueue = static_cast<size_t>(depth);
+        } else if (arg == "--sweep") {
+            options.sweepRows = parseRowCount(arg, value());
+        } else if (arg == "--nested") {
+            auto mode = value();
+            if (mode == "scan") options.singlePassNested = false;
+            else if (mode == "single") options.singlePassNested = true;
+            else throw invalid_argument("unknown --nested mode: " + mode);
+        } else if (arg == "--grouping") {
+            auto mode = value();
+            if (mode == "copy") options.indexedGrouping = false;
+            else if (mode == "index") options.indexedGrouping = true;
+            else throw invalid_argument("unknown --grouping mode: " + mode);
+        } else if (arg == "--groupby") {
+            auto mode = value();
+            if (mode == "lists") options.flatGroupBy = false;
+            else if (mode == "flat") options.flatGroupBy = true;
+            else throw invalid_argument("unknown --groupby mode: " + mode);
+        } else if (arg == "--dates") {
+            auto mode = value();
+            if (mode == "timepoint") options.epochDays = false;
+            else if (mode == "days") options.epochDays = true;
+            else throw invalid_argument("unknown --dates mode: " + mode);
+        } else if (arg == "--threads") {
+            auto count = value();
+            options.threads = static_cast<unsigned>(stoul(count));
+            if (options.threads == 0) throw invalid_argument("--threads must be at least 1");
+        } else if (arg == "--scheduler") {
+            auto mode = value();
+            if (mode == "static") options.workStealing = false;
+            else if (mode == "stealing") options.workStealing = true;
+            else throw invalid_argument("unknown --scheduler mode: " + mode);
+        } else if (arg == "--generator") {
+            auto mode = value();
+            if (mode == "sequential") options.blockedGenerator = false;
+            else if (mode == "blocked") options.blockedGenerator = true;
+            else throw invalid_argument("unknown --generator mode: " + mode);
+        } else if (arg == "--zipf") {
+            options.generator.departmentSkew = stod(value());
+            if (options.generator.departmentSkew < 0) throw invalid_argument("--zipf must not be negative");
+        } else if (arg == "--alloc") {
+            auto mode = value();
+            if (mode == "heap") options.arena = false;
+            else if (mode == "arena") options.arena = true;
+            else throw invalid_argument("unknown --alloc mode: " + mode);
+        } else if (arg == "--name-layouts") {
+            options.nameLayouts = true;
+        } else if (arg == "--incremental") {
+            options.incrementalBatch = parseRowCount(arg, value());
+        } else if (arg == "--indexes") {
+            options.secondaryIndexes = true;
+        } else if (arg == "--pipelines") {
+            options.pipelines = true;
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg == "--numa") {
+            options.numa = true;
+        } else if (arg == "--shared-scan") {
+            options.sharedScan = true;
+        } else if (arg == "--packed") {
+            options.packed = true;
+        } else if (arg == "--groups") {
+            options.costCenters = parseRowCount(arg, value());
+        } else if (arg == "--simd") {
+            auto mode = value();
+            if (mode == "auto") options.simd = detectSimdLevel();
+            else if (mode == "scalar") options.simd = SimdLevel::Scalar;
+            else if (mode == "sse2") options.simd = SimdLevel::Sse2;
+            else if (mode == "avx2") options.simd = SimdLevel::Avx2;
+            else if (mode == "avx512") options.simd = SimdLevel::Avx512;
+            else if (mode == "compare") options.compareFilters = true;
+            else throw invalid_argument("unknown --simd mode: " + mode);
+            
+            if (options.simd > detectSimdLevel()) throw invalid_argument(mode + " is not supported by this CPU");
+        } else if (arg == "--json") {
+            options.jsonPath = value();
+        } else if (arg == "--csv") {
+            options.csvPath = value();
+        } else if (arg == "--warmup") {
+            options.bench.warmups = stoi(value());
+            if (options.bench.warmups < 0) throw invalid_argument("--warmup must not be negative");
+        } else if (arg == "--runs") {
+            options.bench.runs = stoi(value());
+            if (options.bench.runs < 1 || options.bench.runs > kMaxRuns) {
+                throw invalid_argument("--runs must be between 1 and " + to_string(kMaxRuns));
+            }
+        } else if (arg == "--budget") {
+            options.bench.budgetMs = stod(value());
+            if (options.bench.budgetMs < 0) throw invalid_argument("--budget must not be negative");
+        } else if (arg == "--pin") {
+            options.bench.pinCpu = stoi(value());
+            if (!kCanPinThreads) throw invalid_argument("--pin is not supported on this platform");
+            if (options.bench.pinCpu < 0 || options.bench.pinCpu >= static_cast<int>(max(1u, thread::hardware_concurrency()))) {
+                throw invalid_argument("--pin must name a CPU below " + to_string(max(1u, thread::hardware_concurrency())));
+            }
+        } else if (arg == "--counters") {
+            options.counters = true;
+        } else if (arg == "--sort") {
+            options.sort.complex = options.sort.strings = parseSortEngine(arg, value());
+        } else if (arg == "--sort-complex") {
+            options.sort.complex = parseSortEngine(arg, value());
+        } else if (arg == "--sort-strings") {
+            options.sort.strings = parseSortEngine(arg, value());
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        } else {
+            throw invalid_argument("unknown option: " + arg);
+        }
+    }
+    
+    if (options.streamQueue > 0 && options.streamChunk == 0) {
+        throw invalid_argument("--overlap needs --stream");
+    }
+    if (options.streamChunk > 0 && !options.writePath.empty()) {
+        throw invalid_argument("--stream never holds the whole dataset and cannot be combined with --write-data");
+    }
+    if (options.blockedGenerator && (options.streamChunk > 0 || options.sweepRows > 0)) {
+        throw invalid_argument("--generator blocked cannot be combined with --stream or --sweep, which generate sequentially");
+    }
+    if (options.numa && options.bench.pinCpu >= 0) {
+        throw invalid_argument("--pin would move worker 0 off its NUMA node and cannot be combined with --numa");
+    }
+    if (options.sweepRows > 0 && (options.streamChunk > 0 || !options.dataPath.empty())) {
+        throw invalid_argument("--sweep generates its own datasets and cannot be combined with --stream or --data");
+    }
+    if (options.verify && (options.streamChunk > 0 || options.sweepRows > 0)) {
+        throw invalid_argument("--verify cannot be combined with --stream or --sweep");
+    }
+    
+    return options;
+}
+
+// Generates the dataset, or maps it from --data, and writes it to --write-data
+void prepareDataset(const Options& options, vector<Person>& people, PersonTable& table) {
+    auto allocationsBefore = g_allocationCount.load();
+    auto start = high_resolution_clock::now();
+    
+    if (!options.dataPath.empty()) {
+        table = mapDataset(options.dataPath);
+        auto mapped = high_resolution_clock::now();
+        people = toRows(table);
+        auto rebuilt = high_resolution_clock::now();
+        
+        cout << "Mapped " << table.size() << " rows from " << options.dataPath << " in " << fixed << setprecision(2)
+             << duration<double, milli>(mapped - start).count() << "ms, rebuilt rows in "
+             << duration<double, milli>(rebuilt - mapped).count() << "ms\n";
+    } else {
+        unsigned generatorThreads = 1;
+        if (options.blockedGenerator) {
+            generatorThreads = options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency());
+            ThreadPool pool(generatorThreads);
+            people = generateTestDataBlocked(static_cast<int>(options.rows), pool, options.generator);
+        } else {
+            people = generateTestData(static_cast<int>(options.rows), options.generator);
+        }
+        auto generated = high_resolution_clock::now();
+        
+        cout << "Generated " << people.size() << " rows in " << fixed << setprecision(2)
+             << duration<double, milli>(generated - start).count() << "ms, "
+             << g_allocationCount.load() - allocationsBefore << " allocations ("
+             << (options.blockedGenerator ? "blocked, " + to_string(generatorThreads) + " threads" : string("sequential")) << ")\n";
+        
+        table = toColumnar(people);
+    }
+    
+    if (!options.writePath.empty()) {
+        writeDataset(table, options.writePath);
+        cout << "Wrote " << table.size() << " rows to " << options.writePath << "\n";
+    }
+    cout << "\n";
+}
+
+// Writes --json and --csv and returns the exit code of the run
+int finishRun(const Options& options, const string& arguments) {
+    try {
+        if (!options.jsonPath.empty()) writeJsonResults(options.jsonPath, arguments);
+        if (!options.csvPath.empty()) writeCsvResults(options.csvPath, arguments);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+    
+    cout << "Running optimized native C++\n";
+    cout << "Architecture: " << (sizeof(void*) == 8 ? "x64" : "x86") << "\n";
+    
+    g_filters = filterKernelsFor(options.simd);
+    g_strings = stringKernelsFor(options.simd);
+    g_sort = options.sort;
+    g_bench = options.bench;
+    cout << "Filter kernels: " << simdLevelName(g_filters.level)
+         << ", string kernels: " << simdLevelName(g_strings.level) << "\n";
+    cout << "Sort: complex " << sortEngineName(g_sort.complex)
+         << ", strings " << sortEngineName(g_sort.strings) << "\n";
+    cout << "Harness: " << g_bench.warmups << " warm-up, " << g_bench.runs << " timed runs";
+    if (g_bench.budgetMs > 0) cout << " or " << g_bench.budgetMs << "ms";
+    if (g_bench.pinCpu >= 0) cout << ", pinned to CPU " << g_bench.pinCpu;
+    cout << "\n";
+    if (options.counters) {
+        g_counters = make_unique<HardwareCounters>();
+        if (!g_counters->available()) {
+            g_counters.reset();
+            cout << "Hardware counters: not available on this machine\n";
+        }
+    }
+    cout << "\n";
+    
+    string arguments;
+    for (int i = 1; i < argc; ++i) arguments += (i > 1 ? " " : "") + string(argv[i]);
+    
+    if (options.streamChunk > 0) {
+        try {
+            runStreaming(options.dataPath, options.rows, options.streamChunk, options.streamQueue, options.generator);
+        } catch (const exception& e) {
+            cerr << e.what() << "\n";
+            return 1;
+        }
+        return finishRun(options, arguments);
+    }
+    
+    if (options.sweepRows > 0) {
+        measureSweep(options.sweepRows, options.generator);
+        return finishRun(options, arguments);
+    }
+    
+    vector<Person> people;
+    PersonTable table;
+    try {
+        prepareDataset(options, people, table);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    
+    if (options.verify) {
+        return verifyResults(people, table) == 0 ? 0 : 1;
+    }
+    
+    // No separate warm-up dataset: measure() runs every kernel before timing it
+    g_results.rows = table.size();
+    g_results.section = "Performance Test Results";
+    cout << "Performance Test Results:\n========================\n";
+    if (options.indexedGrouping) {
+        if (!sameDepartmentStats(runComplexOperationsIndexed(people), runComplexOperations(people))) {
+            cerr << "Zero-copy grouping does not match the copying version\n";
+            return 1;
+        }
+        measureLayouts("Complex LINQ Chain (index runs)", people, runComplexOperationsIndexed<Person>, table, runComplexOperationsSoA);
+    } else {
+        measureLayouts("Complex LINQ Chain", people, runComplexOperations<Person>, table, runComplexOperationsSoA);
+    }
+    const string dates = options.epochDays ? " (days)" : "";
+    if (options.flatGroupBy) {
+        measureLayouts("GroupBy with Aggregation (flat)" + dates, people, runGroupByFlat<Person>,
+            table, options.epochDays ? runGroupByFlatDaysSoA : runGroupByFlatSoA);
+    } else {
+        measureLayouts("GroupBy with Aggregation" + dates, people, runGroupBy<Person>,
+            table, options.epochDays ? runGroupByDaysSoA : runGroupBySoA);
+    }
+    measureLayouts("String Operations", people, runStringOps<Person>, table, runStringOpsSoA);
+    if (options.singlePassNested) {
+        measureLayouts("Nested Queries (single pass)", people, runNestedSinglePass<Person>, table, runNestedSinglePassSoA);
+    } else {
+        measureLayouts("Nested Queries", people, runNested<Person>, table, runNestedSoA);
+    }
+    measureLayouts("Projection with Where" + dates, people, runProjection<Person>,
+        table, options.epochDays ? runProjectionDaysSoA : runProjectionSoA);
+    
+    if (options.compareFilters) {
+        measureSimdKernels(table);
+    }
+    
+    if (options.nameLayouts) {
+        measureNameLayouts(people);
+    }
+    
+    if (options.arena) {
+        measureArena(people);
+    }
+    
+    if (options.pipelines) {
+        measurePipelines(people);
+    }
+    
+    if (options.incrementalBatch > 0) {
+        measureIncremental(people, options.incrementalBatch, options.generator);
+    }
+    
+    if (options.secondaryIndexes) {
+        measureIndexes(table);
+    }
+    
+    if (options.sharedScan) {
+        measureSharedScan(table);
+    }
+    
+    if (options.packed) {
+        measurePacked(table);
+    }
+    
+    if (options.costCenters > 0) {
+        measureCostCenters(table, options.costCenters, options.generator.departmentSkew,
+            options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency()));
+    }
+    
+    if (options.numa) {
+        measureNuma(people, table, options.threads > 0 ? options.threads : max(1u, thread::hardware_concurrency()));
+    }
+    
+    if (options.threads > 0) {
+        measureScaling(people, options.threads, options.workStealing);
+    }
+    
+    return finishRun(options, arguments);
+}
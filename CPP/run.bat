@@ -1,2 +1,4 @@
-cl /O2 /Oi /Ot /Oy /GL /Ob2 /GS- /Gw /Gy /favor:INTEL64 /arch:AVX2 /fp:fast /QIfist /Qpar /DNDEBUG /D_SECURE_SCL=0 /MT /std:c++17 program.cpp /link /LTCG /OPT:REF /OPT:ICF /STACK:8388608 
+set CFLAGS=/O2 /Oi /Ot /Oy /GL /Ob2 /GS- /Gw /Gy /favor:INTEL64 /arch:AVX2 /fp:fast /QIfist /Qpar /DNDEBUG /D_SECURE_SCL=0 /MT /std:c++17
+set LFLAGS=/LTCG /OPT:REF /OPT:ICF /STACK:8388608
+cl %CFLAGS% /DBW_BUILD_FLAGS="\"%CFLAGS% /link %LFLAGS%\"" program.cpp /link %LFLAGS%
 program.exe
\ No newline at end of file